@@ -0,0 +1,450 @@
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <algorithm>
+#include <functional>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/frame.hpp"
+#include "../include/raster.hpp"
+#include "../include/sink.hpp"
+#include "../include/threadpool.hpp"
+
+typedef struct Size {
+    uint32_t width;
+    uint32_t height;
+} Size;
+
+typedef struct Options {
+    std::vector<uint32_t> boxes = {100, 1000, 10000};
+    std::vector<Size> grids = {{10, 10}, {50, 50}, {200, 100}};    // columns x rows
+    std::vector<Size> terms = {{80, 24}, {200, 60}};
+    std::vector<uint32_t> depths = {8, 64};
+    unsigned threads = 1;               // threads painting each frame, the caller included
+    double minTime = 0.2;               // seconds spent measuring each case
+    std::string filter;                 // only cases whose name contains this are run
+    std::string sink = "fd";            // "fd" encodes the output to /dev/null, "memory" keeps the cells
+    std::string out;                    // JSON file, or empty for the standard output
+} Options;
+
+typedef struct Param {
+    std::string key;
+    std::string value;
+    bool quoted;
+} Param;
+
+typedef struct Case {
+    std::string name;
+    std::vector<Param> params;
+    std::function<void()> reset;        // run untimed before every batch, may be empty
+    std::function<void(size_t)> op;     // one operation, given its index
+    size_t maxBatch = SIZE_MAX;         // operations between resets
+} Case;
+
+typedef struct Result {
+    std::string name;
+    std::vector<Param> params;
+    size_t iterations;
+    double mean;                        // nanoseconds per operation
+    double median;
+    double min;
+} Result;
+
+static ThreadPool *renderPool = NULL;
+static std::string sinkKind;
+static int nullFd = -1;
+
+static Param param(const char *key, uint32_t value)
+{
+    return {key, std::to_string(value), false};
+}
+
+static Param param(const char *key, Size size)
+{
+    return {key, std::to_string(size.width) + "x" + std::to_string(size.height), true};
+}
+
+static double seconds(std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration<double>(d).count();
+}
+
+// time one batch of operations, in seconds
+static double timeBatch(Case &c, size_t start, size_t count)
+{
+    if (c.reset) c.reset();
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) c.op(start + i);
+    return seconds(std::chrono::steady_clock::now() - begin);
+}
+
+static Result measure(Case &c, double minTime)
+{
+    // batches long enough for the clock not to matter
+    const double batchTime = std::max(minTime / 50, 1e-4);
+    size_t batch = 1, done = 0;
+    while (batch < c.maxBatch)
+    {
+        double t = timeBatch(c, done, batch);
+        done += batch;
+        if (t >= batchTime) break;
+        batch = std::min(batch * 2, c.maxBatch);
+    }
+
+    std::vector<double> perOp;
+    double total = 0;
+    size_t iterations = 0;
+    while (total < minTime || perOp.size() < 5)
+    {
+        double t = timeBatch(c, done, batch);
+        done += batch;
+        total += t;
+        iterations += batch;
+        perOp.push_back(t * 1e9 / batch);
+    }
+
+    std::sort(perOp.begin(), perOp.end());
+    return {c.name, c.params, iterations, total * 1e9 / iterations, perOp[perOp.size() / 2], perOp[0]};
+}
+
+// a root frame of the terminal size, with boxes scattered over panels that tile it
+typedef struct Scene {
+    std::unique_ptr<RenderSink> sink;
+    std::unique_ptr<CMDFrame> root;
+    std::vector<CMDBox*> boxes;
+    std::vector<std::string> names;
+} Scene;
+
+static void startScene(Scene &scene, Size term)
+{
+    if (sinkKind == "memory") scene.sink = std::make_unique<MemorySink>(term.width, term.height);
+    else scene.sink = std::make_unique<FdSink>(nullFd);
+
+    scene.root = std::make_unique<CMDFrame>("root", term.width, term.height);
+    scene.root->setRenderPool(renderPool);
+    scene.root->setSink(scene.sink.get());
+}
+
+static Scene buildScene(uint32_t count, Size term)
+{
+    Scene scene;
+    startScene(scene, term);
+    std::mt19937 rng(count ^ (term.width << 16) ^ term.height);
+    auto pick = [&rng](uint32_t n) {return n == 0 ? 0 : (uint32_t)(rng() % n);};
+
+    uint32_t across = std::max<uint32_t>(1, std::min<uint32_t>(4, term.width / 20));
+    uint32_t down = std::max<uint32_t>(1, std::min<uint32_t>(4, term.height / 6));
+    std::vector<CMDFrame*> panels;
+    for (uint32_t y = 0; y < down; ++y)
+    {
+        for (uint32_t x = 0; x < across; ++x)
+        {
+            auto panel = scene.root->addChild(scene.root->create<CMDFrame>("panel" + std::to_string(panels.size()), term.width / across, term.height / down), 0);
+            panel->setPosition(x * (term.width / across), y * (term.height / down));
+            panels.push_back(panel);
+        }
+    }
+
+    scene.root->beginUpdate();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        auto panel = panels[pick(panels.size())];
+        auto made = panel->create<CMDBox>("box" + std::to_string(i), "item", 4 + pick(12), 1 + pick(4));
+        auto box = panel->addChild(std::move(made), pick(3));
+        box->setPosition(panel->getX() + pick(panel->width), panel->getY() + pick(panel->height));
+        box->setBordered(pick(2));
+
+        // half of the boxes are colored, as on a dashboard
+        if (pick(2))
+        {
+            box->setStyle(makeStyle(COLOR_BLACK + pick(16), COLOR_BLACK + pick(8), pick(2) ? ATTR_BOLD : 0));
+            box->setBorderStyle(makeStyle(COLOR_BRIGHT_BLACK + pick(8)));
+        }
+        scene.boxes.push_back(box);
+        scene.names.push_back(box->getName());
+    }
+    scene.root->commitUpdate();
+    scene.root->display();
+    return scene;
+}
+
+// a chain of frames, each inset by a cell from its parent, with a box at the bottom
+static Scene buildNesting(uint32_t depth, Size term)
+{
+    Scene scene;
+    startScene(scene, term);
+
+    CMDFrame *frame = scene.root.get();
+    for (uint32_t i = 0; i < depth; ++i)
+    {
+        auto inner = frame->addChild(frame->create<CMDFrame>("level" + std::to_string(i), std::max<uint32_t>(frame->width, 2) - 1, std::max<uint32_t>(frame->height, 2) - 1), 0);
+        inner->setPosition(1, 1, true);
+        inner->setBorder('.');
+        frame = inner;
+    }
+
+    auto leaf = frame->addChild(frame->create<CMDBox>("leaf", "bottom", 8, 1), 0);
+    scene.boxes.push_back(leaf);
+    scene.names.push_back(leaf->getName());
+    scene.root->display();
+    return scene;
+}
+
+static std::unique_ptr<CMDGrid> buildGrid(Size size)
+{
+    auto grid = std::make_unique<CMDGrid>("grid", size.height, size.width, 4, 1);
+    for (uint32_t row = 0; row < size.height; ++row)
+        for (uint32_t col = 0; col < size.width; ++col) grid->addChild(std::make_unique<CMDBox>("cell", "ab", 2, 1), 0, row, col);
+    return grid;
+}
+
+// whether the filter selects any of `names`, so fixtures only they use are built
+static bool selected(const Options &options, std::initializer_list<const char *> names)
+{
+    for (auto name : names)
+        if (std::string(name).find(options.filter) != std::string::npos) return true;
+    return false;
+}
+
+static void addSceneCases(std::vector<Case> &cases, const Options &options)
+{
+    if (!selected(options, {"display", "display_unchanged", "update_display", "get_element_by_name"})) return;
+    for (auto term : options.terms)
+    {
+        for (auto count : options.boxes)
+        {
+            auto scene = std::make_shared<Scene>(buildScene(count, term));
+            std::vector<Param> params = {param("boxes", count), param("term", term)};
+
+            // every cell is compared and written again
+            cases.push_back({"display", params, nullptr, [scene](size_t) {
+                scene->root->invalidateScreen();
+                scene->root->display();
+            }});
+
+            // nothing changed, so nothing is written
+            cases.push_back({"display_unchanged", params, nullptr, [scene](size_t) {
+                scene->root->display();
+            }});
+
+            cases.push_back({"update_display", params, nullptr, [scene](size_t i) {
+                CMDBox *box = scene->boxes[i % scene->boxes.size()];
+                box->setText((i / scene->boxes.size()) % 2 ? "item" : "meti");
+                scene->root->updateDisplay(box);
+            }});
+
+            cases.push_back({"get_element_by_name", params, nullptr, [scene](size_t i) {
+                CMDBox *found = scene->root->getElementByName(scene->names[i * 7919 % scene->names.size()]);
+                if (found == NULL) std::abort();
+            }});
+        }
+    }
+}
+
+static void addGridCases(std::vector<Case> &cases, const Options &options)
+{
+    if (!selected(options, {"grid_set_width", "grid_set_height", "grid_add_row"})) return;
+    for (auto size : options.grids)
+    {
+        std::vector<Param> params = {param("grid", size)};
+        auto grid = std::shared_ptr<CMDGrid>(buildGrid(size));
+
+        // each resize moves every cell after the column or row
+        cases.push_back({"grid_set_width", params, nullptr, [grid](size_t i) {
+            uint32_t col = i % grid->columns.count;
+            grid->setWidth(col, grid->columns.colwidth[col] == 4 ? 5 : 4);
+        }});
+
+        cases.push_back({"grid_set_height", params, nullptr, [grid](size_t i) {
+            uint32_t row = i % grid->rows.count;
+            grid->setHeight(row, grid->rows.rowheight[row] == 1 ? 2 : 1);
+        }});
+
+        // rows are added to a fresh grid every batch, so it does not grow without bound
+        auto grown = std::make_shared<std::unique_ptr<CMDGrid>>();
+        cases.push_back({"grid_add_row", params, [grown, size] {*grown = buildGrid(size);}, [grown](size_t) {
+            (*grown)->addRow();
+        }, 256});
+    }
+}
+
+static void addNestingCases(std::vector<Case> &cases, const Options &options)
+{
+    if (!selected(options, {"nested_display", "nested_update_display", "nested_get_element_by_name"})) return;
+    for (auto term : options.terms)
+    {
+        for (auto depth : options.depths)
+        {
+            auto scene = std::make_shared<Scene>(buildNesting(depth, term));
+            std::vector<Param> params = {param("depth", depth), param("term", term)};
+
+            cases.push_back({"nested_display", params, nullptr, [scene](size_t) {
+                scene->root->invalidateScreen();
+                scene->root->display();
+            }});
+
+            cases.push_back({"nested_update_display", params, nullptr, [scene](size_t i) {
+                scene->boxes[0]->setText(i % 2 ? "bottom" : "mottob");
+                scene->root->updateDisplay(scene->boxes[0]);
+            }});
+
+            cases.push_back({"nested_get_element_by_name", params, nullptr, [scene](size_t) {
+                if (scene->root->getElementByName("leaf") == NULL) std::abort();
+            }});
+        }
+    }
+}
+
+static void writeJSON(FILE *file, const Options &options, const std::vector<Result> &results)
+{
+    char date[32];
+    time_t now = time(NULL);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    fprintf(file, "{\n  \"schema\": 1,\n  \"date\": \"%s\",\n", date);
+    fprintf(file, "  \"kernels\": \"%.*s\",\n", (int)rasterKernels().size(), rasterKernels().data());
+    fprintf(file, "  \"sink\": \"%s\",\n", options.sink.c_str());
+    fprintf(file, "  \"threads\": %u,\n  \"min_time_s\": %g,\n  \"results\": [", options.threads, options.minTime);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &r = results[i];
+        fprintf(file, "%s\n    {\"name\": \"%s\"", i == 0 ? "" : ",", r.name.c_str());
+        for (auto &p : r.params)
+            fprintf(file, p.quoted ? ", \"%s\": \"%s\"" : ", \"%s\": %s", p.key.c_str(), p.value.c_str());
+        fprintf(file, ", \"iterations\": %zu, \"ns_per_op\": %.1f, \"median_ns\": %.1f, \"min_ns\": %.1f}",
+                r.iterations, r.mean, r.median, r.min);
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+static bool parseList(const char *text, std::vector<uint32_t> &out)
+{
+    out.clear();
+    for (const char *p = text; *p != '\0';)
+    {
+        char *end;
+        unsigned long n = strtoul(p, &end, 10);
+        if (end == p || n == 0) return false;
+        out.push_back(n);
+        p = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return false;
+    }
+    return !out.empty();
+}
+
+static bool parseSizes(const char *text, std::vector<Size> &out)
+{
+    out.clear();
+    for (const char *p = text; *p != '\0';)
+    {
+        char *end;
+        unsigned long w = strtoul(p, &end, 10);
+        if (end == p || *end != 'x' || w == 0) return false;
+        p = end + 1;
+        unsigned long h = strtoul(p, &end, 10);
+        if (end == p || h == 0) return false;
+        out.push_back({(uint32_t)w, (uint32_t)h});
+        if (*end != ',' && *end != '\0') return false;
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return !out.empty();
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --boxes N,...        boxes in the display scenes (default 100,1000,10000)\n"
+        "  --grid CxR,...       grid sizes, in columns x rows (default 10x10,50x50,200x100)\n"
+        "  --term WxH,...       terminal sizes (default 80x24,200x60)\n"
+        "  --depth N,...        frame nesting depths (default 8,64)\n"
+        "  --threads N          threads painting each frame (default 1)\n"
+        "  --min-time SECONDS   time spent measuring each case (default 0.2)\n"
+        "  --filter TEXT        only run cases whose name contains TEXT\n"
+        "  --kernels NAME       raster kernels: avx2, sse2 or scalar (default: best supported)\n"
+        "  --sink NAME          fd to encode the output to /dev/null, or memory (default fd)\n"
+        "  --out FILE           write the JSON results to FILE instead of the standard output\n",
+        program);
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        bool ok = value != NULL;
+        if (arg == "--help" || arg == "-h") { usage(argv[0]); return 0; }
+        else if (!ok) {}
+        else if (arg == "--boxes") ok = parseList(value, options.boxes);
+        else if (arg == "--grid") ok = parseSizes(value, options.grids);
+        else if (arg == "--term") ok = parseSizes(value, options.terms);
+        else if (arg == "--depth") ok = parseList(value, options.depths);
+        else if (arg == "--threads") ok = (options.threads = strtoul(value, NULL, 10)) > 0;
+        else if (arg == "--min-time") ok = (options.minTime = strtod(value, NULL)) > 0;
+        else if (arg == "--filter") options.filter = value;
+        else if (arg == "--kernels") ok = useRasterKernels(value);
+        else if (arg == "--sink") ok = (options.sink = value) == "fd" || options.sink == "memory";
+        else if (arg == "--out") options.out = value;
+        else ok = false;
+
+        if (!ok)
+        {
+            fprintf(stderr, "%s: bad option %s\n", argv[0], argv[i]);
+            usage(argv[0]);
+            return 2;
+        }
+        ++i;
+    }
+
+    FILE *json = options.out.empty() ? stdout : fopen(options.out.c_str(), "w");
+    if (json == NULL)
+    {
+        fprintf(stderr, "%s: cannot open %s: %s\n", argv[0], options.out.c_str(), strerror(errno));
+        return 1;
+    }
+
+    // the encoded output is thrown away, so only producing it is measured
+    sinkKind = options.sink;
+    nullFd = open("/dev/null", O_WRONLY);
+    if (nullFd < 0)
+    {
+        fprintf(stderr, "%s: cannot open /dev/null: %s\n", argv[0], strerror(errno));
+        return 1;
+    }
+
+    std::unique_ptr<ThreadPool> pool;
+    if (options.threads > 1)
+    {
+        pool = std::make_unique<ThreadPool>(options.threads);
+        renderPool = pool.get();
+    }
+
+    std::vector<Case> cases;
+    addSceneCases(cases, options);
+    addGridCases(cases, options);
+    addNestingCases(cases, options);
+
+    std::vector<Result> results;
+    for (auto &c : cases)
+    {
+        if (c.name.find(options.filter) == std::string::npos) continue;
+
+        Result r = measure(c, options.minTime);
+        std::string label = r.name;
+        for (auto &p : r.params) label += " " + p.key + "=" + p.value;
+        fprintf(stderr, "%-48s %12.1f ns/op %10zu ops\n", label.c_str(), r.mean, r.iterations);
+        results.push_back(r);
+    }
+
+    writeJSON(json, options, results);
+    return fclose(json) == 0 ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+#ifndef CELL_HPP
+#define CELL_HPP
+#pragma once
+
+#include <cstdint>
+
+typedef uint64_t Cell;                  // glyph in the low 32 bits, 0 for a hole; style in the high 32 bits
+typedef uint32_t Style;                 // colors and attributes, 0 for the defaults of the terminal
+
+// glyph of the right half of a wide character, whose code point is in the cell before it
+inline constexpr uint32_t WIDE_CONTINUATION = 0x110000;
+
+typedef enum {
+    COLOR_DEFAULT = 0,
+    COLOR_BLACK,
+    COLOR_RED,
+    COLOR_GREEN,
+    COLOR_YELLOW,
+    COLOR_BLUE,
+    COLOR_MAGENTA,
+    COLOR_CYAN,
+    COLOR_WHITE,
+    COLOR_BRIGHT_BLACK,
+    COLOR_BRIGHT_RED,
+    COLOR_BRIGHT_GREEN,
+    COLOR_BRIGHT_YELLOW,
+    COLOR_BRIGHT_BLUE,
+    COLOR_BRIGHT_MAGENTA,
+    COLOR_BRIGHT_CYAN,
+    COLOR_BRIGHT_WHITE
+} Color;
+
+typedef enum {
+    ATTR_BOLD = 1 << 0,
+    ATTR_DIM = 1 << 1,
+    ATTR_ITALIC = 1 << 2,
+    ATTR_UNDERLINE = 1 << 3,
+    ATTR_BLINK = 1 << 4,
+    ATTR_REVERSE = 1 << 5,
+    ATTR_STRIKE = 1 << 6
+} Attribute;
+
+/**
+ * @brief Get a color of the 256-color palette
+ *
+ * @param n Index in the palette; 0 to 15 are the named colors
+ * @return uint32_t color, for `makeStyle`
+ */
+inline uint32_t paletteColor(uint8_t n) {return n + 1;}
+
+/**
+ * @brief Pack colors and attributes into a style
+ *
+ * @param fg Foreground color, a `Color` or from `paletteColor`
+ * @param bg Background color, a `Color` or from `paletteColor`
+ * @param attrs `Attribute` bits
+ * @return Style packing all three
+ */
+inline Style makeStyle(uint32_t fg, uint32_t bg = COLOR_DEFAULT, uint32_t attrs = 0) {return fg | bg << 9 | attrs << 18;}
+
+inline uint32_t styleForeground(Style style) {return style & 0x1ff;}
+inline uint32_t styleBackground(Style style) {return (style >> 9) & 0x1ff;}
+inline uint32_t styleAttributes(Style style) {return (style >> 18) & 0xff;}
+
+/**
+ * @brief Pack a glyph and its style into a cell
+ *
+ * @param glyph Code point of the cell, 0 for a hole
+ * @param style Style of the cell
+ * @return Cell packing both
+ */
+inline Cell makeCell(uint32_t glyph, Style style = 0) {return (Cell)style << 32 | glyph;}
+
+inline uint32_t cellGlyph(Cell cell) {return (uint32_t)cell;}
+inline Style cellStyle(Cell cell) {return (Style)(cell >> 32);}
+
+#endif
@@ -0,0 +1,1255 @@
+#ifndef FRAME_HPP
+#define FRAME_HPP
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <stdexcept>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <memory_resource>
+#include "sink.hpp"
+#include "pool.hpp"
+#include "threadpool.hpp"
+#include "stats.hpp"
+#include "cell.hpp"
+#include "unicode.hpp"
+
+class CMDBox;
+class CMDGrid;
+class CMDFrame;
+
+typedef struct RowData {
+    uint32_t count;
+    std::vector<uint32_t> rowheight;
+} RowData;
+
+typedef struct ColumnData {
+    uint32_t count;
+    std::vector<uint32_t> colwidth;
+} ColumnData;
+
+typedef struct Bordering {              // code points, each taking one column
+    uint32_t topleft;
+    uint32_t topright;
+    uint32_t botmleft;
+    uint32_t botmright;
+    uint32_t topbody;
+    uint32_t botmbody;
+    uint32_t leftbody;
+    uint32_t rightbody;
+} Bordering;
+
+typedef struct TextLine {
+    uint32_t start;                     // first column of the line in the laid out text
+    uint32_t length;                    // columns in the line
+} TextLine;
+
+typedef struct Rect {
+    int left;
+    int top;
+    int right;                          // exclusive
+    int bottom;                         // exclusive
+} Rect;
+
+typedef struct FrameBuffer {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<Cell> cells;            // row-major, 0 where nothing was painted
+} FrameBuffer;
+
+typedef struct NameHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view nom) const {return std::hash<std::string_view>{}(nom);}
+} NameHash;
+
+typedef std::pmr::unordered_multimap<std::string, CMDBox*, NameHash, std::equal_to<>> NameIndex;
+
+typedef struct Indexing {
+    int zindex;
+    std::pmr::vector<CMDBox*> members;
+} Indexing;
+
+typedef enum TextPosition
+{
+    TRUE_CENTER,
+    CENTER_LEFT,
+    CENTER_RIGHT,
+    TOP_CENTER,
+    TOP_LEFT,
+    TOP_RIGHT,
+    BOTTOM_LEFT,
+    BOTTOM_RIGHT,
+    BOTTOM_CENTER
+} TextPosition;
+
+class CMDBox
+{
+    public:
+
+        uint32_t width;                         // width of the box, changed with setSize
+        uint32_t height;                        // height of the box, changed with setSize
+        int32_t offx = 0;                       // x-position of the box, relative to its parent
+        int32_t offy = 0;                       // y-position of the box, relative to its parent
+        std::string inner;                      // inner text in UTF-8, changed with setText
+        Bordering borders;                      // borders of the box
+        bool isVisible = true;                  // visibility of box
+		bool isTransparent = false;				// transparency of the box
+        CMDBox *parent = NULL;                  // pointer to parent of box
+        int zindex = 0;                         // z-index of the box in its parent frame
+        TextPosition boxPosition = TOP_LEFT;    // position of the box
+        TextPosition textPosition = TOP_LEFT;   // position of the text
+        Style style = 0;                        // colors and attributes of the background and text
+        Style borderStyle = 0;                  // colors and attributes of the borders
+
+        /**
+         * @brief Construct a new CMDBox object
+         * 
+         * @param nom Name of the box
+         */
+        CMDBox(std::string nom) : width(10), height(10), inner(""), borders({' ', 0, 0, 0, 0, 0, 0, 0}), name(nom) {claimAllocation(); measureText();}
+        
+        /**
+         * @brief Construct a new CMDBox object
+         * 
+         * @param nom Name of the box
+         * @param body Body of the box, its width setting the width of the box
+         */
+        CMDBox(std::string nom, std::string body) : width(textWidth(body)), height(1), inner(body), borders({' ', 0, 0, 0, 0, 0, 0, 0}), name(nom) {claimAllocation(); measureText();}
+
+        /**
+         * @brief Construct a new CMDBox object
+         * 
+         * @param nom Name of the box
+         * @param wid Width of the box
+         * @param hig Height of the box
+         */
+        CMDBox(std::string nom, uint32_t wid, uint32_t hig) : width(wid), height(hig), inner(""), borders({' ', 0, 0, 0, 0, 0, 0, 0}), name(nom) {claimAllocation(); measureText();}
+
+        /**
+         * @brief Construct a new CMDBox object
+         * 
+         * @param nom Name of the box
+         * @param body Body of the box
+         * @param wid Width of the box
+         * @param hig Height of the box
+         */
+        CMDBox(std::string nom, std::string body, uint32_t wid, uint32_t hig) : width(wid), height(hig), inner(body), borders({' ', 0, 0, 0, 0, 0, 0, 0}), name(nom) {claimAllocation(); measureText();}
+
+        /**
+         * @brief Destroy the CMDBox object
+         * 
+         * A box destroyed while a frame still holds it is removed from the
+         * frame first.
+         */
+        virtual ~CMDBox();
+
+        CMDBox(const CMDBox&) = delete;
+        CMDBox& operator=(const CMDBox&) = delete;
+
+        /**
+         * @brief Allocate a box on the heap
+         * 
+         * Every box records where it was allocated, so `delete` returns it
+         * there. Allocating says nothing about who owns the box.
+         * 
+         * @param size Size of the box
+         */
+        static void* operator new(size_t size);
+
+        /**
+         * @brief Allocate a box from a pool
+         * 
+         * @param size Size of the box
+         * @param pool Pool to allocate from, or NULL for the heap
+         */
+        static void* operator new(size_t size, NodePool *pool);
+
+        /**
+         * @brief Construct a box in memory the caller provides
+         * 
+         * The box records no allocation, and must be destroyed rather than
+         * deleted.
+         * 
+         * @param size Size of the box
+         * @param place Memory for the box
+         */
+        static void* operator new(size_t size, void *place);
+
+        /**
+         * @brief Free a box allocated by `new` or `new (pool)`
+         * 
+         * @param p Address of the box
+         */
+        static void operator delete(void *p);
+
+        /**
+         * @brief Free a pooled box whose constructor threw
+         * 
+         * @param p Address of the box
+         */
+        static void operator delete(void *p, NodePool*);
+
+        /**
+         * @brief Leave the memory of a box constructed in place whose constructor threw
+         * 
+         */
+        static void operator delete(void*, void*);
+
+        /**
+         * @brief Get the pool used for allocations made on behalf of the box
+         * 
+         * Pooled boxes use the pool they were allocated from. Other boxes
+         * create a pool of their own the first time one is needed.
+         * 
+         * @return NodePool*, a pointer to the pool
+         */
+        NodePool* getPool();
+
+        /**
+         * @brief Check whether the frame holding the box owns it
+         * 
+         * @return true if the box was handed to the frame as a `std::unique_ptr`, and is deleted along with it
+         */
+        bool isOwned() const {return owned;}
+
+        /**
+         * @brief Get the character at a given position
+         * 
+         * @param x X-coordinate
+         * @param y Y-coordinate
+         * @return uint32_t code point at position `(x,y)`, `WIDE_CONTINUATION`
+         *         right of a wide character, or 0 if nothing is there
+         */
+        uint32_t getCharIn(uint32_t x, uint32_t y);
+
+        /**
+         * @brief Get the cell at a given position, with its style
+         * 
+         * @param x X-coordinate
+         * @param y Y-coordinate
+         * @return Cell at position `(x,y)`, or 0 if nothing is there
+         */
+        Cell getCellIn(uint32_t x, uint32_t y);
+
+        /**
+         * @brief Composite a horizontal run of cells of the box
+         * 
+         * Borders, background and the slice of `inner` text on row `y` are
+         * written as runs. Cells the box does not cover are left untouched.
+         * 
+         * @param x X-coordinate of the first cell of the run
+         * @param y Y-coordinate of the row
+         * @param len Number of cells in the run
+         * @param out Cells of the run, `out[0]` being at `x`
+         */
+        virtual void getSpan(uint32_t x, uint32_t y, uint32_t len, Cell *out);
+
+        /**
+         * @brief Paint the box into a framebuffer
+         * 
+         * Writes every non-empty cell that `getCellIn` would return for
+         * the cells inside `clip`, one run per row, and leaves all other
+         * cells untouched.
+         * 
+         * @param fb Framebuffer covering absolute coordinates
+         * @param clip Area of the framebuffer that may be written
+         */
+        virtual void paint(FrameBuffer &fb, Rect clip);
+
+        /**
+         * @brief Set all borders of the box
+         * 
+         * @param ch Code point of the border, one column wide
+         */
+        virtual void setBorder(uint32_t ch);
+
+        /**
+         * @brief Set the colors and attributes of the background and text
+         * 
+         * @param st Style of the box
+         */
+        void setStyle(Style st);
+
+        /**
+         * @brief Set the colors and attributes of the borders
+         * 
+         * Grids use it for their table borders too.
+         * 
+         * @param st Style of the borders
+         */
+        void setBorderStyle(Style st);
+
+        /**
+         * @brief Set the bordered status
+         * 
+         * @param isBordered boolean indicating whether the table is to be bordered
+         */
+        virtual void setBordered(bool isBordered) {bordered = isBordered; breakLines(); damage();}
+
+        /**
+         * @brief Get the bordered status
+         * 
+         * @return Current bordered status
+         */
+        virtual bool getBordered(bool) {return bordered;}
+
+        /**
+         * @brief Set the position of the box
+         * 
+         * @param x X-coordinate
+         * @param y Y-coordinate
+         * @param isRelative checks whether the position is relative or absolute
+         */
+        virtual void setPosition(uint32_t x, uint32_t y, bool isRelative = false);
+
+        /**
+         * @brief Get the absolute x-position of the box
+         * 
+         * @return Column of the left edge of the box on the screen
+         */
+        uint32_t getX() {refreshPosition(); return absx;}
+
+        /**
+         * @brief Get the absolute y-position of the box
+         * 
+         * @return Row of the top edge of the box on the screen
+         */
+        uint32_t getY() {refreshPosition(); return absy;}
+
+        /**
+         * @brief Shift the box by X and Y offsets
+         * 
+         * @param x X-coordinate offset
+         * @param y Y-coordinate offset
+         */
+        virtual void shift(int x, int y);
+
+        /**
+         * @brief Set the position of the box
+         * 
+         * @param pos Code marking the position of the box
+         */
+        virtual void setPosition(TextPosition pos);
+
+        /**
+         * @brief Set the size of the box
+         * 
+         * The inner text is wrapped again to the new width, and both the area
+         * the box covered and the one it covers now are redisplayed.
+         * 
+         * @param wid Width of the box
+         * @param hig Height of the box
+         */
+        virtual void setSize(uint32_t wid, uint32_t hig);
+
+        /**
+         * @brief Set the width of the box, keeping its height
+         * 
+         * @param wid Width of the box
+         */
+        void setWidth(uint32_t wid) {setSize(wid, height);}
+
+        /**
+         * @brief Set the height of the box, keeping its width
+         * 
+         * @param hig Height of the box
+         */
+        void setHeight(uint32_t hig) {setSize(width, hig);}
+
+        /**
+         * @brief Set Z-index of object in Frame
+         * 
+         * @param zindex Z-index value
+         */
+        virtual void setZIndex(int zindex);
+
+        /**
+         * @brief Get child by name
+         * 
+         * @param nom Name of element to be gotten
+         * @return CMDBox*, a pointer to the first element encountered with the name
+         */
+        virtual CMDBox* getElementByName(std::string_view nom);
+
+        /**
+         * @brief Rename the box, keeping the name index of its root up to date
+         * 
+         * @param nom New name of the box
+         */
+        void setName(std::string nom);
+
+        /**
+         * @brief Get the name of the box
+         * 
+         * @return const std::string&, the name given on construction or by setName
+         */
+        const std::string& getName() const {return name;}
+
+        /**
+         * @brief Call a function on every direct child of the box
+         * 
+         * @param fn Function to be called
+         */
+        virtual void forEachChild(const std::function<void(CMDBox*)> &) {}
+
+        /**
+         * @brief Check if address is identical to or is a child of box
+         * 
+         * @param addr Address of element
+         * @return true if box is parent of addr, false otherwise
+         */
+        virtual bool isParentTo(CMDBox* addr);
+
+        /**
+         * @brief Set the inner text of the box
+         * 
+         * The text is wrapped at spaces to the width inside the borders, and
+         * broken at every newline.
+         * 
+         * @param text Text to be displayed
+         */
+        void setText(std::string text);
+
+        /**
+         * @brief Get the lines the inner text is wrapped into
+         * 
+         * The line breaks are cached, and only found again once the text or
+         * the width inside the borders changes.
+         * 
+         * @return const std::vector<TextLine>& lines, from the top
+         */
+        const std::vector<TextLine>& getTextLines();
+
+        /**
+         * @brief Get the area covered by the box and all of its contents
+         * 
+         * The area is cached relative to the box, so it survives moves of the
+         * box and is only recomputed after its contents change.
+         * 
+         * @return Rect bounding everything the box may paint
+         */
+        Rect getBounds();
+
+        /**
+         * @brief Mark the cached bounds of the box, and of everything holding it, as outdated
+         * 
+         */
+        void invalidateBounds();
+
+        /**
+         * @brief Check whether the bounds of the box are cached
+         * 
+         * @return true if `getBounds` returned a cached area and will keep doing so until a change
+         */
+        bool hasCachedBounds() const {return boundsValid;}
+
+        /**
+         * @brief Check whether painting the box writes every cell of its area
+         * 
+         * Opaque boxes hide whatever lies below them, so it is not painted.
+         * 
+         * @return true if the box is visible, not transparent and has no empty borders
+         */
+        virtual bool isOpaque();
+
+        /**
+         * @brief Get the frame at the top of the tree containing the box
+         * 
+         * @return CMDFrame* at the root, or NULL if the root is not a frame
+         */
+        CMDFrame* getRootFrame();
+
+        /**
+         * @brief Mark the area covered by the box as needing to be redisplayed
+         * 
+         * The area is recorded on the root frame, and redisplayed by its next
+         * `flush`. Mutators call this on their own. Fields changed without
+         * one, such as `isVisible`, need it afterwards.
+         */
+        void damage();
+
+        /**
+         * @brief Start a batch of changes to the box
+         * 
+         * Size, position and structure changes made to the box or anything
+         * under it until the matching `commitUpdate` are recorded, and laid out
+         * once at the end. Their damage is recorded as the area of the box
+         * before and after the batch. Batches may be nested, the outermost one
+         * laying out everything. Grids in the middle of a batch are displayed
+         * as they were last laid out.
+         */
+        void beginUpdate();
+
+        /**
+         * @brief End a batch of changes, laying out the boxes it deferred once
+         * 
+         */
+        void commitUpdate();
+
+        /**
+         * @brief Get the outermost batch open on the box or the boxes holding it
+         * 
+         * @return CMDBox*, the box the batch was begun on, or NULL outside of batches
+         */
+        CMDBox* openBatch();
+
+    protected:
+        std::string name;                       // name of the box, changed with setName
+        bool bordered = false;                  // bordered status of the box
+        NodePool *pool = NULL;                  // pool for allocations made on behalf of the box
+        bool ownsPool = false;                  // pool was created by the box itself
+        bool owned = false;                     // deleted by the frame holding it
+        uint32_t absx = 0;                      // cached absolute x-position
+        uint32_t absy = 0;                      // cached absolute y-position
+        uint64_t absGeneration = 0;             // move count of the tree the cached position belongs to
+        uint64_t moveCount = 1;                 // moves in the tree the box is the root of
+        uint64_t *treeMoves = &moveCount;       // move count of the root of the tree holding the box
+        uint32_t updateDepth = 0;               // nesting of beginUpdate calls
+        bool layoutPending = false;             // layout deferred until the batch is committed
+        bool batchLayoutPending = false;        // a box under this batch deferred its layout
+        Rect boundsCache = {0, 0, 0, 0};        // bounds of the box and its contents, relative to the box
+        bool boundsValid = false;               // whether boundsCache is up to date
+        uint32_t textColumns = 0;               // columns taken by `inner` laid out, a newline taking one
+        std::vector<uint32_t> textGlyphs;       // `inner` laid out one glyph per column, empty for plain ASCII
+        std::vector<TextLine> textLines;        // `inner` broken into lines
+        uint32_t wrapWidth = 0;                 // width inside the borders the lines were broken for
+
+        /**
+         * @brief Recompute the cached absolute position if anything has moved since
+         * 
+         */
+        void refreshPosition();
+
+        /**
+         * @brief Invalidate every cached absolute position in the tree after a move
+         * 
+         */
+        void moved() {++*treeMoves;}
+
+        /**
+         * @brief Count the moves of a box and its contents with those of another tree
+         * 
+         * @param box Address of the box
+         * @param moves Move count of the root of the tree
+         */
+        static void joinTree(CMDBox *box, uint64_t *moves);
+
+        /**
+         * @brief Count the moves of a box and its contents on the box itself, as the root of its own tree
+         * 
+         * @param box Address of the box
+         */
+        static void leaveTree(CMDBox *box) {joinTree(box, &box->moveCount);}
+
+        /**
+         * @brief Compute the area covered by the box and all of its contents
+         * 
+         * @param cacheable Cleared if the area may change without the contents changing
+         * @return Rect bounding everything the box may paint, in absolute coordinates
+         */
+        virtual Rect computeBounds(bool &cacheable);
+
+        /**
+         * @brief Lay out the box now, or when the current batch is committed
+         * 
+         */
+        void requestLayout();
+
+        /**
+         * @brief Lay out the contents of the box after a change
+         * 
+         */
+        virtual void applyLayout() {}
+
+        /**
+         * @brief Lay out the box, timing the layout while statistics are collected
+         * 
+         */
+        void layout();
+
+        /**
+         * @brief Record the pool the box was allocated from, if `operator new` allocated it
+         * 
+         */
+        void claimAllocation();
+
+        /**
+         * @brief Get the memory resource for containers of the box
+         * 
+         * Pooled boxes use their pool. Other boxes use the heap rather than
+         * creating a pool of their own.
+         * 
+         * @return std::pmr::memory_resource*, a pointer to the resource
+         */
+        std::pmr::memory_resource* resource() {return pool != NULL ? (std::pmr::memory_resource*)pool : std::pmr::new_delete_resource();}
+
+        /**
+         * @brief Lay out every box under a box whose layout was deferred
+         * 
+         * @param box Address of the box
+         */
+        static void layoutDeferred(CMDBox *box);
+
+        /**
+         * @brief Mark whether the frame holding a box owns it
+         * 
+         * @param box Address of the box
+         * @param own Whether the box is deleted along with the frame
+         */
+        static void setOwned(CMDBox *box, bool own) {box->owned = own;}
+
+        /**
+         * @brief Take the box out of the frame holding it, if any, keeping it alive
+         * 
+         */
+        void detach();
+
+        /**
+         * @brief Measure `inner`, laying it out by column unless it is plain ASCII
+         * 
+         */
+        void measureText();
+
+        /**
+         * @brief Break `inner` into lines fitting the width inside the borders
+         * 
+         */
+        void breakLines();
+
+        /**
+         * @brief Get the origin of a line of the inner text
+         * 
+         * @param len Columns in the line
+         * @param lines Number of lines of the text
+         * @param textx X-coordinate of the first character of the line
+         * @param texty Y-coordinate of the first line
+         */
+        void getTextOrigin(uint32_t len, size_t lines, int64_t &textx, int64_t &texty);
+};
+
+class CMDFrame : public CMDBox
+{
+    public:
+
+        std::string title;          // title of the frame
+
+        /**
+         * @brief Construct a new CMDFrame object
+         * 
+         */
+        CMDFrame() : CMDBox("root") {}
+        
+        /**
+         * @brief Construct a new CMDFrame object
+         * 
+         */
+        CMDFrame(std::string nom) : CMDBox(nom) {}
+
+        /**
+         * @brief Construct a new CMDFrame object
+         * 
+         * @param wid Width of the frame
+         * @param hig Height of the frame
+         */
+        CMDFrame(std::string nom, uint32_t wid, uint32_t hig) : CMDBox(nom, wid, hig) {}
+
+        /**
+         * @brief Construct a new CMDFrame object
+         * 
+         * @param nom Name of the frame
+         * @param wid Width of the frame
+         * @param hig Height of the frame
+         * @param body Body text in the frame
+         */
+        CMDFrame(std::string nom, std::string body, uint32_t wid, uint32_t hig) : CMDBox(nom, body, wid, hig) {}
+
+        /**
+         * @brief Destroy the CMDFrame object, and every child it owns
+         * 
+         * Children it does not own are let go, and left to their owners.
+         */
+        ~CMDFrame();
+
+        /**
+         * @brief Create a box in the pool of the tree containing the frame
+         * 
+         * @param args Arguments passed to the constructor of `T`
+         * @return std::unique_ptr<T> owning the new box, until it is handed to `addChild`
+         */
+        template <typename T, typename... Args>
+        std::unique_ptr<T> create(Args&&... args)
+        {
+            auto root = getRootFrame();
+            return std::unique_ptr<T>(new ((root != NULL ? root : this)->getPool()) T(std::forward<Args>(args)...));
+        }
+
+        /**
+         * @brief Add child to frame, leaving it owned by the caller
+         * 
+         * A child already in a frame is moved out of it, and keeps the owner
+         * it had there.
+         * 
+         * @param child Address of child to be added
+         * @param zindex Z-index of child
+         */
+        void addChild(CMDBox *child, int zindex);
+
+        /**
+         * @brief Add child to frame, which takes ownership of it
+         * 
+         * @param child Child to be added, deleted along with the frame
+         * @param zindex Z-index of child
+         * @return T*, a pointer to the child
+         */
+        template <typename T>
+        T* addChild(std::unique_ptr<T> child, int zindex)
+        {
+            T *box = child.release();
+            addChild(box, zindex);
+            setOwned(box, true);
+            return box;
+        }
+
+        /**
+         * @brief Remove child from frame
+         * 
+         * @param child Address of child to be removed
+         * @return std::unique_ptr<CMDBox> owning the child if the frame owned
+         *         it, empty otherwise
+         */
+        std::unique_ptr<CMDBox> removeChild(CMDBox *child);
+
+        /**
+         * @brief Move a child to another z-level
+         * 
+         * @param child Address of the child
+         * @param zindex New z-index of the child
+         */
+        void setChildZIndex(CMDBox *child, int zindex);
+
+        /**
+         * @brief Display the frame, and all of its contents
+         * 
+         * Only the cells that differ from the previously displayed screen are
+         * written to the console.
+         */
+        void display();
+
+        /**
+         * @brief Redisplay the area covered by an element
+         * 
+         * @param elName Name of the element
+         */
+        void updateDisplay(std::string_view elName);
+
+        /**
+         * @brief Redisplay the area covered by an element
+         * 
+         * @param child Address of the element
+         */
+        void updateDisplay(CMDBox* child);
+
+        /**
+         * @brief Forget the previously displayed screen
+         * 
+         * Call this after the console has been cleared, so that the next
+         * display writes every cell again.
+         */
+        void invalidateScreen();
+
+        /**
+         * @brief Redisplay every area damaged since the last display
+         * 
+         */
+        void flush();
+
+        /**
+         * @brief Paint the frame in bands of rows on several threads
+         * 
+         * The output is the same as painting serially. The pool is not owned
+         * by the frame, and must outlive its use.
+         * 
+         * @param pool Pool painting the bands, or NULL to paint on the calling thread
+         */
+        void setRenderPool(ThreadPool *pool);
+
+        /**
+         * @brief Send the output of the frame somewhere other than the standard output
+         * 
+         * The next display writes every cell to the new sink. The sink is not
+         * owned by the frame, and must outlive its use.
+         * 
+         * @param target Sink receiving the changed cells, or NULL for the standard output
+         */
+        void setSink(RenderSink *target);
+
+        /**
+         * @brief Get the sink receiving the output of the frame
+         * 
+         * @return RenderSink* in use
+         */
+        RenderSink* getSink() {return sink;}
+
+        /**
+         * @brief Start or stop collecting counters for every frame displayed
+         * 
+         * A frame is one call to display, updateDisplay or flush. While no
+         * frame collects counters, counting costs a single test.
+         * 
+         * @param enabled Whether counters are collected
+         */
+        void setStatsEnabled(bool enabled);
+
+        /**
+         * @brief Get the counters of the last frame displayed
+         * 
+         * Layouts are timed on the calling thread since the previous frame,
+         * and go to the first frame collecting counters that is displayed.
+         * 
+         * @return const FrameStats& counters, all 0 before the first frame
+         */
+        const FrameStats& getFrameStats() const {return lastStats;}
+
+        /**
+         * @brief Write every frame displayed from now on to a Chrome trace
+         * 
+         * Counters are collected while the trace is written. The file can be
+         * opened in chrome://tracing or Perfetto once the trace is stopped.
+         * 
+         * @param path File the trace is written to
+         * @return true if the file was opened
+         */
+        bool startTrace(const std::string &path);
+
+        /**
+         * @brief Finish the trace started by startTrace
+         * 
+         */
+        void stopTrace();
+
+        /**
+         * @brief Record a layout done in the tree of the frame, if it writes a trace
+         * 
+         * @param span Time taken by the layout
+         */
+        void addLayoutSpan(TraceSpan span);
+
+        /**
+         * @brief Record an area of the frame as needing to be redisplayed
+         * 
+         * Overlapping and adjacent areas are merged where that does not add
+         * undamaged cells.
+         * 
+         * @param area Damaged area, in absolute coordinates
+         */
+        void addDamage(Rect area);
+
+
+        /**
+         * @brief Composite a horizontal run of the frame and all of its children
+         * 
+         * @param x X-coordinate of the first cell of the run
+         * @param y Y-coordinate of the row
+         * @param len Number of cells in the run
+         * @param out Cells of the run, `out[0]` being at `x`
+         */
+        void getSpan(uint32_t x, uint32_t y, uint32_t len, Cell *out) override;
+
+        /**
+         * @brief Paint the frame and all of its children into a framebuffer
+         * 
+         * @param fb Framebuffer covering absolute coordinates
+         * @param clip Area of the framebuffer that may be written
+         */
+        void paint(FrameBuffer &fb, Rect clip) override;
+
+        /**
+         * @brief Get child by name
+         * 
+         * Trees rooted in a frame are searched through the name index of the
+         * root. If several elements share the name, the first one met depth
+         * first, in the order of `forEachChild`, is returned.
+         * 
+         * @param nom Name of element to be gotten
+         * @return CMDBox*, a pointer to the first element encountered with the name
+         */
+        CMDBox* getElementByName(std::string_view nom) override;
+
+        /**
+         * @brief Call a function on every child of the frame
+         * 
+         * @param fn Function to be called
+         */
+        void forEachChild(const std::function<void(CMDBox*)> &fn) override;
+
+        /**
+         * @brief Add a box and all of its contents to the name index
+         * 
+         * @param box Address of the box
+         */
+        void indexNames(CMDBox *box);
+
+        /**
+         * @brief Remove a box and all of its contents from the name index
+         * 
+         * @param box Address of the box
+         */
+        void unindexNames(CMDBox *box);
+
+        /**
+         * @brief Look up a name in the name index
+         * 
+         * Names held by a single box inside `within` are answered by the
+         * index alone. Shared names are searched for depth first, so the
+         * first box with the name is found.
+         * 
+         * @param nom Name of element to be gotten
+         * @param within Address of the box whose contents are searched
+         * @return CMDBox*, a pointer to the first element with the name inside `within`
+         */
+        CMDBox* findName(std::string_view nom, CMDBox *within);
+
+        /**
+         * @brief Check if address is identical to or is a child of box
+         * 
+         * @param addr Address of element
+         * @return true if box is parent of addr, false otherwise
+         */
+        virtual bool isParentTo(CMDBox* addr) override;
+
+    private:
+        std::pmr::vector<Indexing> levels{resource()};                  // z-levels, highest first
+        std::pmr::vector<std::pmr::vector<CMDBox*>> spareLevels{resource()};    // member lists of emptied levels
+        FrameBuffer framebuffer;    // composited screen, used when displaying
+        std::vector<Cell> screen;   // cells as last written to the console
+        std::vector<Rect> damaged;  // areas to be redisplayed by flush
+        ThreadPool *renderPool = NULL;  // threads painting bands of the frame, or NULL to paint serially
+        bool collecting = false;        // counters are kept for every frame displayed
+        FrameStats stats;               // counters of the frame being displayed
+        FrameStats lastStats;           // counters of the last frame displayed
+        uint64_t frameStart = 0;        // stat clock at the start of the frame being displayed, or 0
+        std::vector<BandStats> bandStats;   // time and counters of each band, while painting
+        std::unique_ptr<TraceFile> trace;   // trace being written, if any
+        std::vector<TraceSpan> layoutSpans; // layouts in the tree since the last frame, while a trace is written
+        FdSink console;             // standard output, written to unless another sink is set
+        RenderSink *sink = &console;    // receives the changed cells of every frame
+        NameIndex names{0, NameHash(), std::equal_to<>(), resource()};  // named descendants, kept while the frame is a root
+
+        /**
+         * @brief Compute the area covered by the frame and all of its children
+         * 
+         * @param cacheable Cleared if a child may be held at the screen edge
+         * @return Rect bounding everything the frame may paint
+         */
+        Rect computeBounds(bool &cacheable) override;
+
+        /**
+         * @brief Composite an area of the frame and queue the changed cells
+         * 
+         * @param area Area of the frame to be redisplayed
+         */
+        void render(Rect area);
+
+        /**
+         * @brief Clear and composite a band of the framebuffer
+         * 
+         * @param band Area of the frame to be composited
+         * @param index Number of the band, indexing `bandStats`
+         */
+        void paintBand(Rect band, size_t index);
+
+        /**
+         * @brief Write the queued console output, ending the frame
+         * 
+         */
+        void writeOutput();
+
+        /**
+         * @brief Start counting the time of the frame, if not started yet
+         * 
+         * @return uint64_t stat clock now, or 0 if counters are not collected
+         */
+        uint64_t startFrame();
+
+        /**
+         * @brief Find the z-level for a z-index, inserting it if needed
+         * 
+         * @param zindex Z-index of the level
+         * @return Indexing& for the level
+         */
+        Indexing& levelFor(int zindex);
+
+        /**
+         * @brief Take a child out of its z-level
+         * 
+         * @param child Address of the child
+         * @return true if the child was found, false otherwise
+         */
+        bool unlinkChild(CMDBox *child);
+};
+
+class CMDGrid : public CMDBox
+{
+    public:
+        RowData rows;                   // table row data
+        ColumnData columns;             // table column data
+        bool sizeByContents = false;    // row and column size adjustable when on
+        
+        /**
+         * @brief Construct a new CMDGrid object
+         * 
+         * @param nom Name of the grid
+         * @param r Number of rows in the grid
+         * @param c Number of columns in the grid
+         */
+        CMDGrid(std::string nom, uint32_t r, uint32_t c) : CMDBox(nom, 0, 0), tableborderch(' ') {
+            // initialize row and col data (no nullptrs pls...)
+            rows.count = 0;
+            columns.count = 0;
+            rows.rowheight = std::vector<uint32_t>();
+            columns.colwidth = std::vector<uint32_t>();
+            layoutRows(0);
+            layoutColumns(0);
+            
+            // initialize rows
+            for (uint32_t i = 0; i < r; ++i) addRow();
+            
+            // initialize columns
+            for (uint32_t i = 0; i < c; ++i) addColumn();
+        }
+
+        /**
+         * @brief Destroy the CMDGrid object, and all of its cells
+         * 
+         */
+        ~CMDGrid();
+
+        /**
+         * @brief Construct a new CMDGrid object
+         * 
+         * @param nom Name of the grid
+         * @param r Number of rows in the grid
+         * @param c Number of columns in the grid
+         * @param wid Width of each column
+         * @param hig Height of each row
+         */
+        CMDGrid(std::string nom, uint32_t r, uint32_t c, uint32_t wid, uint32_t hig) : CMDGrid(nom, r, c) {
+            // set height and width of grid, laying it out once
+            beginUpdate();
+            for (uint32_t i = 0; i < rows.count; ++i) setHeight(i, hig);
+            for (uint32_t i = 0; i < columns.count; ++i) setWidth(i, wid);
+            commitUpdate();
+        }
+
+        /**
+         * @brief Get cell at coordinates
+         * 
+         * @param col Column of cell
+         * @param row Row of cell
+         * @return CMDFrame* at `row` and `column`
+         */
+        CMDFrame* at(uint32_t col, uint32_t row);
+
+        /**
+         * @brief Add a row to the table.
+         * 
+         */
+        void addRow();
+
+        /**
+         * @brief Add a column to the table.
+         * 
+         */
+        void addColumn();
+
+        /**
+         * @brief Delete a row from the table.
+         * 
+         * @param row Index of the row.
+         */
+        void deleteRow(uint32_t row);
+
+        /**
+         * @brief Delete a column from the table.
+         * 
+         * @param col Index of the column.
+         */
+        void deleteColumn(uint32_t col);
+
+        /**
+         * @brief Set the height of the row of a table
+         * 
+         * @param row Index of the row
+         * @param hig Height value to be added
+         */
+        void setHeight(uint32_t row, uint32_t hig);
+
+        /**
+         * @brief Set the Bordered object
+         * 
+         * @param isBordered boolean indicating whether the table is to be bordered
+         */
+        virtual void setBordered(bool isBordered) override;
+
+        /**
+         * @brief Set the width of the column of a table
+         * 
+         * @param col Index of the column
+         * @param wid Width value to be added
+         */
+        void setWidth(uint32_t col, uint32_t wid);
+
+        /**
+         * @brief Grids are sized by their rows and columns, so this does nothing
+         * 
+         * @param wid Ignored
+         * @param hig Ignored
+         */
+        virtual void setSize(uint32_t, uint32_t) override {}
+
+        /**
+         * @brief Composite a horizontal run of the cells and table borders
+         * 
+         * @param x X-coordinate of the first cell of the run
+         * @param y Y-coordinate of the row
+         * @param len Number of cells in the run
+         * @param out Cells of the run, `out[0]` being at `x`
+         */
+        virtual void getSpan(uint32_t x, uint32_t y, uint32_t len, Cell *out) override;
+
+        /**
+         * @brief Grids are never treated as opaque, as empty cells and borders may show through
+         * 
+         * @return false
+         */
+        virtual bool isOpaque() override {return false;}
+
+        /**
+         * @brief Get child by name
+         * 
+         * @param nom Name of element to be gotten
+         * @return CMDBox*, a pointer to the first element encountered with the name
+         */
+        virtual CMDBox* getElementByName(std::string_view nom) override;
+
+        /**
+         * @brief Call a function on every cell of the grid
+         * 
+         * @param fn Function to be called
+         */
+        virtual void forEachChild(const std::function<void(CMDBox*)> &fn) override;
+
+        /**
+         * @brief Check if address is identical to or is a child of box
+         * 
+         * @param addr Address of element
+         * @return true if box is parent of addr, false otherwise
+         */
+        virtual bool isParentTo(CMDBox* addr) override;
+
+        /**
+         * @brief Add child to Grid, leaving it owned by the caller
+         * 
+         * @param child Address of child to be added
+         * @param row Index of the row
+         * @param col Index of the column
+         * @param zindex Z-index of child
+         */
+        void addChild(CMDBox *child, int zindex, uint32_t row, uint32_t col);
+
+        /**
+         * @brief Add child to Grid, whose cell takes ownership of it
+         * 
+         * @param child Child to be added, deleted along with its cell
+         * @param zindex Z-index of child
+         * @param row Index of the row
+         * @param col Index of the column
+         * @return T*, a pointer to the child, or NULL if there is no such cell and the child was deleted
+         */
+        template <typename T>
+        T* addChild(std::unique_ptr<T> child, int zindex, uint32_t row, uint32_t col)
+        {
+            if (row >= rows.count || col >= columns.count) return NULL;
+            T *box = child.release();
+            addChild(box, zindex, row, col);
+            setOwned(box, true);
+            return box;
+        }
+
+        /**
+         * @brief Set all borders of the box
+         * 
+         * @param ch Code point of the border, one column wide
+         */
+        virtual void setBorder(uint32_t ch) override;
+
+    protected:
+        std::vector<CMDFrame*> cells;   // row-major cells, `stride` slots per row
+        uint32_t stride = 0;            // slots per row, at least the column count
+        uint32_t tableborderch;         // code point used for table borders
+        std::vector<uint32_t> colStart; // x-offset of each column, then the width of the grid
+        std::vector<uint32_t> rowStart; // y-offset of each row, then the height of the grid
+        std::vector<int32_t> colAt;     // column at each x-offset, or -1 on a table border
+        std::vector<int32_t> rowAt;     // row at each y-offset, or -1 on a table border
+        std::vector<CMDFrame*> placed;  // cells as last laid out, `placedColumns` per row, drawn until the next layout
+        uint32_t placedColumns = 0;     // columns in the last layout
+        uint32_t placedBorder = 0;      // width of the table borders in the last layout
+        std::vector<CMDFrame*> retired; // cells deleted since the last layout, freed once it is replaced
+
+        /**
+         * @brief Recompute the column offsets from a column onwards
+         * 
+         * @param from Index of the first column that changed
+         */
+        void layoutColumns(uint32_t from);
+
+        /**
+         * @brief Recompute the row offsets from a row onwards
+         * 
+         * @param from Index of the first row that changed
+         */
+        void layoutRows(uint32_t from);
+
+        /**
+         * @brief Move and resize cells to match the row and column offsets
+         * 
+         * @param fromRow Cells in this row and below are placed
+         * @param fromCol Cells in this column and to the right are placed
+         */
+        void placeCells(uint32_t fromRow, uint32_t fromCol);
+
+        /**
+         * @brief Get the slot holding a cell
+         * 
+         * @param row Index of the row
+         * @param col Index of the column
+         * @return CMDFrame*& slot of the cell at `row` and `col`
+         */
+        CMDFrame*& slot(uint32_t row, uint32_t col) {return cells[(size_t)row * stride + col];}
+
+        static constexpr uint32_t NO_CHANGE = UINT32_MAX;
+        uint32_t pendingRow = NO_CHANGE;    // first row whose layout changed
+        uint32_t pendingCol = NO_CHANGE;    // first column whose layout changed
+        bool pendingResize = false;         // size changed, so the grid is anchored again
+
+        /**
+         * @brief Record a change in layout, and lay out now unless in a batch
+         * 
+         * @param row First row whose layout changed, or NO_CHANGE
+         * @param col First column whose layout changed, or NO_CHANGE
+         * @param resized Whether the change affects the size of rows or columns
+         */
+        void requestLayout(uint32_t row, uint32_t col, bool resized);
+
+        /**
+         * @brief Recompute offsets and place cells for all recorded changes
+         * 
+         */
+        void applyLayout() override;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,142 @@
+#ifndef OUTPUT_HPP
+#define OUTPUT_HPP
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "cell.hpp"
+
+class OutputBuffer
+{
+    public:
+
+        /**
+         * @brief Queue a cursor move to a console position
+         * 
+         * @param x Column, starting at 0
+         * @param y Row, starting at 0
+         */
+        void moveTo(uint32_t x, uint32_t y);
+
+        /**
+         * @brief Queue the cheapest cursor move from a known position
+         * 
+         * Picks among an absolute move, relative moves, and a carriage return
+         * followed by line feeds, whichever takes the fewest bytes.
+         * 
+         * @param fromx Column of the cursor
+         * @param fromy Row of the cursor
+         * @param tox Column to move to
+         * @param toy Row to move to
+         * @param exact false if the cursor may be held on the last column after
+         *              a write, one column left of `fromx`
+         * @param feed Whether line feeds may be used, the row moved to being on
+         *             the screen; past its bottom they would scroll it
+         */
+        void moveFrom(uint32_t fromx, uint32_t fromy, uint32_t tox, uint32_t toy, bool exact, bool feed);
+
+        /**
+         * @brief Get the number of bytes `moveFrom` would queue, given the same parameters
+         * 
+         * @return size_t bytes of the cheapest move, 0 if the cursor is already there
+         */
+        static size_t moveCost(uint32_t fromx, uint32_t fromy, uint32_t tox, uint32_t toy, bool exact, bool feed);
+
+        /**
+         * @brief Queue text at the current cursor position
+         * 
+         * @param text Characters to be written
+         * @param len Number of characters
+         */
+        void write(const char *text, size_t len);
+
+        /**
+         * @brief Queue the glyphs of a run of cells in UTF-8, ignoring their styles
+         * 
+         * @param cells First cell of the run
+         * @param len Number of cells
+         */
+        void writeGlyphs(const Cell *cells, size_t len);
+
+        /**
+         * @brief Queue REP, repeating the character written last
+         * 
+         * @param n Number of repeats
+         */
+        void repeat(uint32_t n) {writeControl(n, 'b');}
+
+        /**
+         * @brief Queue ECH, blanking cells from the cursor on without moving it
+         * 
+         * @param n Number of cells
+         */
+        void eraseChars(uint32_t n) {writeControl(n, 'X');}
+
+        /**
+         * @brief Queue EL, blanking the row from the cursor to its end
+         * 
+         */
+        void eraseLine() {write("\x1b[K", 3);}
+
+        /**
+         * @brief Get the number of bytes a control sequence with one parameter takes
+         * 
+         * @param n Parameter, left out when it is 1
+         * @return size_t bytes of the sequence
+         */
+        static size_t sequenceCost(uint32_t n);
+
+        /**
+         * @brief Queue the SGR sequence changing the style of the text written next
+         * 
+         * Only the colors and attributes that differ are changed, and nothing
+         * is queued if the styles are the same.
+         * 
+         * @param from Style in effect
+         * @param to Style wanted
+         */
+        void setStyle(Style from, Style to);
+
+        /**
+         * @brief Drop everything queued
+         * 
+         * The buffer keeps its capacity, so a steady stream of frames does
+         * not allocate.
+         */
+        void clear() {data.clear();}
+
+        /**
+         * @brief Get the bytes queued
+         * 
+         * @return const char* first byte queued
+         */
+        const char* bytes() const {return data.data();}
+
+        /**
+         * @brief Get the number of bytes queued
+         * 
+         * @return size_t number of bytes
+         */
+        size_t size() const {return data.size();}
+
+    private:
+        std::vector<char> data;         // queued bytes
+
+        /**
+         * @brief Queue a number in decimal
+         * 
+         * @param n Number to be written
+         */
+        void writeNumber(uint32_t n);
+
+        /**
+         * @brief Queue a control sequence with one parameter, left out when it is 1
+         * 
+         * @param n Parameter
+         * @param final Final byte of the sequence
+         */
+        void writeControl(uint32_t n, char final);
+};
+
+#endif
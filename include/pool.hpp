@@ -0,0 +1,42 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+class NodePool : public std::pmr::memory_resource
+{
+    public:
+
+        /**
+         * @brief Create a new pool, referenced by its creator
+         * 
+         * @return NodePool*, a pointer to the new pool
+         */
+        static NodePool* create();
+
+        /**
+         * @brief Drop the reference held by the creator of the pool
+         * 
+         * The pool is destroyed, releasing all of its memory at once, when the
+         * creator has released it and every allocation has been returned.
+         */
+        void release();
+
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {return this == &other;}
+
+    private:
+        std::pmr::unsynchronized_pool_resource blocks;  // size-classed free lists over large chunks
+        size_t refs = 1;                                // live allocations, plus the creator
+
+        NodePool() {}
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef RASTER_HPP
+#define RASTER_HPP
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include "cell.hpp"
+
+/**
+ * @brief Fill a run of cells with one cell
+ * 
+ * @param dst First cell of the run
+ * @param cell Cell to be written
+ * @param len Number of cells
+ */
+void fillRow(Cell *dst, Cell cell, size_t len);
+
+/**
+ * @brief Copy a run of cells
+ * 
+ * @param dst First cell written
+ * @param src First cell read
+ * @param len Number of cells
+ */
+void blitRow(Cell *dst, const Cell *src, size_t len);
+
+/**
+ * @brief Composite a run of ASCII text onto cells, in one style
+ * 
+ * Characters of `text` that are 0 are holes, and leave the cell below
+ * untouched.
+ * 
+ * @param dst First cell written
+ * @param text First character of the run
+ * @param len Number of characters
+ * @param style Style given to the characters
+ */
+void compositeText(Cell *dst, const char *text, size_t len, Style style);
+
+/**
+ * @brief Composite a run of laid out glyphs onto cells, in one style
+ * 
+ * @param dst First cell written
+ * @param glyphs First glyph of the run, one per column, 0 for a hole
+ * @param len Number of glyphs
+ * @param style Style given to the glyphs
+ */
+void compositeText(Cell *dst, const uint32_t *glyphs, size_t len, Style style);
+
+/**
+ * @brief Get the name of the kernels in use
+ * 
+ * @return "avx2", "sse2" or "scalar"
+ */
+std::string_view rasterKernels();
+
+/**
+ * @brief Switch to another set of kernels, if the processor supports it
+ * 
+ * The best set supported is picked on first use, so this is only needed to
+ * compare them.
+ * 
+ * @param name "avx2", "sse2" or "scalar"
+ * @return true if the kernels are now in use
+ */
+bool useRasterKernels(std::string_view name);
+
+#endif
@@ -0,0 +1,226 @@
+#ifndef SINK_HPP
+#define SINK_HPP
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unistd.h>
+#include "output.hpp"
+
+class RenderSink
+{
+    public:
+
+        virtual ~RenderSink() {}
+
+        /**
+         * @brief Write a run of cells on one row
+         * 
+         * @param x Column of the first cell, starting at 0
+         * @param y Row of the cells, starting at 0
+         * @param cells Glyphs and styles of the cells, none of them holes
+         * @param len Number of cells
+         */
+        virtual void writeRun(uint32_t x, uint32_t y, const Cell *cells, size_t len) = 0;
+
+        /**
+         * @brief Move the cursor, where it is left once the frame is written
+         * 
+         * @param x Column, starting at 0
+         * @param y Row, starting at 0
+         */
+        virtual void moveCursor(uint32_t x, uint32_t y) = 0;
+
+        /**
+         * @brief Get what moving between two positions of a row costs the sink
+         * 
+         * Unchanged cells between two runs are written again when that costs
+         * no more than moving over them.
+         * 
+         * @param fromx Column where the cursor is left by a run
+         * @param tox Column of the next run
+         * @param y Row of both runs
+         * @return size_t bytes the move takes, 0 if moving is free
+         */
+        virtual size_t moveCost(uint32_t, uint32_t, uint32_t) const {return 0;}
+
+        /**
+         * @brief Deliver everything written since the last flush
+         * 
+         * Called once at the end of every frame.
+         * 
+         * @return size_t number of bytes delivered
+         */
+        virtual size_t flush() = 0;
+};
+
+typedef enum {
+    CAP_REPEAT = 1 << 0,                // REP, repeating the last character
+    CAP_ERASE = 1 << 1                  // ECH and EL, blanking cells
+} Capability;
+
+class FdSink : public RenderSink
+{
+    public:
+
+        /**
+         * @brief Construct a sink writing ANSI escape sequences to a file descriptor
+         * 
+         * Styles are set with SGR sequences where they change from one cell
+         * to the next, and reset at the end of every frame. Within a frame the
+         * cursor is moved from run to run by whatever sequence is shortest.
+         * 
+         * @param fd Descriptor written to, not closed by the sink
+         */
+        explicit FdSink(int fd = STDOUT_FILENO) : fd(fd) {}
+
+        void writeRun(uint32_t x, uint32_t y, const Cell *cells, size_t len) override;
+        void moveCursor(uint32_t x, uint32_t y) override;
+        size_t moveCost(uint32_t fromx, uint32_t tox, uint32_t y) const override;
+
+        /**
+         * @brief Set the control sequences the console understands
+         * 
+         * Stretches of one character are then repeated or erased where that
+         * takes fewer bytes than writing them. None are assumed by default.
+         * 
+         * @param caps `Capability` bits
+         */
+        void setCapabilities(uint32_t caps) {capabilities = caps;}
+        uint32_t getCapabilities() const {return capabilities;}
+
+        /**
+         * @brief Set the width of the console, so blanks reaching its edge can be erased at once
+         * 
+         * @param wid Number of columns, 0 if unknown
+         */
+        void setColumns(uint32_t wid) {columns = wid;}
+
+        /**
+         * @brief Write everything queued with as few system calls as possible
+         * 
+         * The buffer is emptied but keeps its capacity, so a steady stream of
+         * frames does not allocate. Writing stops at the first error other than
+         * an interrupted call.
+         * 
+         * @return size_t number of bytes written
+         */
+        size_t flush() override;
+
+    protected:
+        int fd;                         // descriptor written to
+        OutputBuffer output;            // bytes queued since the last flush
+        Style current = 0;              // style of the terminal once the queued bytes are written
+        uint32_t cursorx = 0;           // cursor once the queued bytes are written, if known
+        uint32_t cursory = 0;
+        bool cursorKnown = false;       // the cursor is lost between frames, as others may write
+        bool cursorExact = false;       // false after a run, which may leave it held on the last column
+        uint32_t capabilities = 0;
+        uint32_t columns = 0;           // width of the console, 0 if unknown
+
+        /**
+         * @brief Queue the change back to the default style, if needed
+         * 
+         */
+        void resetStyle();
+
+        /**
+         * @brief Queue the cheapest cursor move to a position
+         * 
+         * @param x Column, starting at 0
+         * @param y Row, starting at 0
+         * @param feed Whether the row is known to be on the screen
+         */
+        void seek(uint32_t x, uint32_t y, bool feed);
+
+        /**
+         * @brief Queue cells of one style, repeating or erasing stretches of the same cell
+         * 
+         * @param x Column of the first cell
+         * @param y Row of the cells
+         * @param cells First cell
+         * @param len Number of cells
+         * @param last Whether the cells end the run, so the cursor may be left behind
+         */
+        void writeStretches(uint32_t x, uint32_t y, const Cell *cells, size_t len, bool last);
+};
+
+class MemorySink : public RenderSink
+{
+    public:
+
+        /**
+         * @brief Construct a sink keeping the cells written in memory
+         * 
+         * The screen grows to fit whatever is written to it.
+         * 
+         * @param wid Initial width of the screen
+         * @param hig Initial height of the screen
+         */
+        MemorySink(uint32_t wid = 0, uint32_t hig = 0);
+
+        void writeRun(uint32_t x, uint32_t y, const Cell *cells, size_t len) override;
+        void moveCursor(uint32_t x, uint32_t y) override {cursorx = x; cursory = y;}
+
+        /**
+         * @brief End a frame; nothing needs to be delivered
+         * 
+         * @return size_t number of cells written since the last flush
+         */
+        size_t flush() override;
+
+        /**
+         * @brief Get the character at a position of the screen
+         * 
+         * @param x Column, starting at 0
+         * @param y Row, starting at 0
+         * @return uint32_t code point at the position, a space outside of the screen
+         */
+        uint32_t at(uint32_t x, uint32_t y) const {return cellGlyph(cellAt(x, y));}
+
+        /**
+         * @brief Get the cell at a position of the screen, with its style
+         * 
+         * @param x Column, starting at 0
+         * @param y Row, starting at 0
+         * @return Cell at the position, a blank in the default style outside of the screen
+         */
+        Cell cellAt(uint32_t x, uint32_t y) const;
+
+        /**
+         * @brief Get the screen as text
+         * 
+         * @return std::string with the rows of the screen in UTF-8, separated by newlines
+         */
+        std::string toString() const;
+
+        /**
+         * @brief Blank every cell, keeping the size of the screen
+         * 
+         */
+        void clear();
+
+        uint32_t getWidth() const {return width;}
+        uint32_t getHeight() const {return height;}
+        uint32_t getCursorX() const {return cursorx;}
+        uint32_t getCursorY() const {return cursory;}
+
+    private:
+        uint32_t width;
+        uint32_t height;
+        std::vector<Cell> cells;        // row-major
+        uint32_t cursorx = 0;
+        uint32_t cursory = 0;
+        size_t written = 0;             // cells written since the last flush
+
+        /**
+         * @brief Grow the screen to hold a position
+         * 
+         * @param wid Width needed
+         * @param hig Height needed
+         */
+        void reserve(uint32_t wid, uint32_t hig);
+};
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+#pragma once
+
+#include <cstdio>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+typedef struct FrameStats {
+    uint64_t frame = 0;                 // frames counted so far, this one included
+    uint64_t spansPainted = 0;          // runs of cells composited by boxes
+    uint64_t boxesVisited = 0;          // boxes painted, or searched for cells
+    uint64_t cellsChanged = 0;          // cells that differ from the previous screen
+    uint64_t bytesWritten = 0;          // bytes delivered by the sink
+    uint64_t layoutNs = 0;              // time spent laying out grids since the previous frame
+    uint64_t rasterNs = 0;              // time spent compositing the framebuffer
+    uint64_t outputNs = 0;              // time spent comparing and writing changed cells
+} FrameStats;
+
+typedef struct StatCounters {
+    uint64_t spansPainted;
+    uint64_t boxesVisited;
+    uint64_t layoutNs;
+} StatCounters;
+
+typedef struct TraceSpan {
+    uint64_t start;                     // nanoseconds on the stat clock
+    uint64_t duration;
+    uint32_t thread;                    // number of the thread, see statThread
+} TraceSpan;
+
+typedef struct BandStats {
+    TraceSpan span;                     // time spent painting the band
+    StatCounters counters;              // counted while painting the band
+} BandStats;
+
+// frames collecting statistics; counting is skipped while there are none, on every thread
+inline std::atomic<uint32_t> statsUsers{0};
+
+// counters of the calling thread, taken and reset by the frames collecting statistics
+inline thread_local StatCounters statCounters = {0, 0, 0};
+
+/**
+ * @brief Count a run of cells composited by a box
+ * 
+ */
+inline void countSpan() {if (statsUsers.load(std::memory_order_relaxed) != 0) ++statCounters.spansPainted;}
+
+/**
+ * @brief Count boxes painted or searched for cells
+ * 
+ * @param n Number of boxes
+ */
+inline void countBoxVisits(uint64_t n) {if (statsUsers.load(std::memory_order_relaxed) != 0) statCounters.boxesVisited += n;}
+
+/**
+ * @brief Read the monotonic clock used for statistics
+ * 
+ * @return uint64_t nanoseconds since an arbitrary point
+ */
+uint64_t statClock();
+
+/**
+ * @brief Get a small number identifying the calling thread in traces
+ * 
+ * @return uint32_t number of the thread, 1 for the first to ask
+ */
+uint32_t statThread();
+
+class TraceFile
+{
+    public:
+
+        /**
+         * @brief Close the trace, if open
+         * 
+         */
+        ~TraceFile();
+
+        /**
+         * @brief Start writing a trace
+         * 
+         * @param path File the trace is written to, replaced if it exists
+         * @return true if the file was opened
+         */
+        bool open(const std::string &path);
+
+        /**
+         * @brief Finish the trace
+         * 
+         * The file is only valid Chrome trace JSON once closed.
+         */
+        void close();
+
+        /**
+         * @brief Check whether a trace is being written
+         * 
+         * @return true if a file is open
+         */
+        bool isOpen() const {return file != NULL;}
+
+        /**
+         * @brief Write a complete event
+         * 
+         * @param name Name of the event
+         * @param span Time and thread of the event
+         * @param stats Counters attached to the event as arguments, or NULL
+         */
+        void span(const char *name, TraceSpan span, const FrameStats *stats = NULL);
+
+        /**
+         * @brief Write a counter event for the counters of a frame
+         * 
+         * @param time Time of the end of the frame, on the stat clock
+         * @param stats Counters of the frame
+         */
+        void counters(uint64_t time, const FrameStats &stats);
+
+        TraceFile() {}
+        TraceFile(const TraceFile&) = delete;
+        TraceFile& operator=(const TraceFile&) = delete;
+
+    private:
+        FILE *file = NULL;
+        bool empty = true;              // no event written yet
+
+        /**
+         * @brief Start an event, separating it from the previous one
+         * 
+         */
+        void startEvent();
+};
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef TERMINAL_HPP
+#define TERMINAL_HPP
+#pragma once
+
+#include <cstdint>
+#include <termios.h>
+#include "sink.hpp"
+
+class TerminalSink : public FdSink
+{
+    public:
+
+        /**
+         * @brief Construct a sink driving a POSIX terminal
+         * 
+         * Nothing is changed on the terminal until `open` is called.
+         * 
+         * @param fd Descriptor of the terminal, not closed by the sink
+         */
+        explicit TerminalSink(int fd = STDOUT_FILENO) : FdSink(fd) {}
+
+        /**
+         * @brief Restore the terminal, if it was opened
+         * 
+         */
+        ~TerminalSink();
+
+        /**
+         * @brief Take over the terminal
+         * 
+         * Input echo and line buffering are turned off, and the alternate
+         * screen is shown, cleared, with the cursor hidden. Signals from the
+         * keyboard are still generated. Blanks are erased rather than written
+         * from then on, and repeated characters use REP if the terminal is seen
+         * to understand it.
+         * 
+         * SIGINT, SIGTERM, SIGHUP and SIGQUIT, if they still have their default
+         * action, restore the terminal before ending the process, until
+         * `close`. Only one open sink at a time does this. Signals the
+         * application handles or ignores are left to it, and it must `close`
+         * the sink before exiting.
+         * 
+         * @return true if the terminal was set up, false if `fd` is not a terminal
+         */
+        bool open();
+
+        /**
+         * @brief Give the terminal back as it was before `open`
+         * 
+         * Leaves the alternate screen, shows the cursor, restores the terminal
+         * modes and puts back the previous signal actions.
+         * 
+         */
+        void close();
+
+        /**
+         * @brief Check whether the sink has taken over the terminal
+         * 
+         * @return true between `open` and `close`
+         */
+        bool isOpen() const {return opened;}
+
+        /**
+         * @brief Get the size of the terminal
+         * 
+         * @param wid Set to the number of columns
+         * @param hig Set to the number of rows
+         * @return true if the size is known
+         */
+        bool getSize(uint32_t &wid, uint32_t &hig) const;
+
+        /**
+         * @brief Wrap every frame in synchronized output, so it is shown at once
+         * 
+         * Uses DEC private mode 2026, which terminals without it ignore. On by
+         * default.
+         * 
+         * @param enabled Whether frames are synchronized
+         */
+        void setSynchronized(bool enabled) {synchronized = enabled;}
+
+        void writeRun(uint32_t x, uint32_t y, const Cell *cells, size_t len) override;
+        void moveCursor(uint32_t x, uint32_t y) override;
+
+        /**
+         * @brief Write the frame, ending the synchronized update it started
+         * 
+         * @return size_t number of bytes written
+         */
+        size_t flush() override;
+
+    private:
+        struct termios saved;           // terminal modes before `open`
+        bool opened = false;
+        bool synchronized = true;
+        bool syncing = false;           // a synchronized update was started for the frame being written
+        bool started = false;           // a frame was started since the last flush
+
+        /**
+         * @brief Start a frame, unless one is already started
+         * 
+         * Picks up the width of the terminal, and starts a synchronized update.
+         */
+        void startFrame();
+
+        /**
+         * @brief Check whether the terminal understands REP
+         * 
+         * Asks for the cursor position after repeating a blank, waiting a
+         * moment for the answer.
+         * 
+         * @return true if the blank was repeated
+         */
+        bool probeRepeat();
+
+        /**
+         * @brief Restore the terminal on signals that would end the process
+         * 
+         */
+        void watchSignals();
+
+        /**
+         * @brief Put back the signal actions replaced by `watchSignals`
+         * 
+         */
+        void unwatchSignals();
+
+        /**
+         * @brief Queue a control sequence
+         * 
+         * @param seq Sequence to be written
+         */
+        void control(const char *seq);
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+class ThreadPool
+{
+    public:
+
+        /**
+         * @brief Start a pool of worker threads
+         * 
+         * @param threads Number of threads running tasks, including the caller of `run`
+         */
+        explicit ThreadPool(unsigned threads);
+
+        /**
+         * @brief Stop and join every worker
+         * 
+         */
+        ~ThreadPool();
+
+        /**
+         * @brief Run a task for every index, and wait for all of them to finish
+         * 
+         * The calling thread runs tasks too. Runs must not be nested.
+         * 
+         * @param count Number of tasks
+         * @param task Task to be run, given its index
+         */
+        void run(size_t count, const std::function<void(size_t)> &task);
+
+        /**
+         * @brief Get the number of threads running tasks, including the caller
+         * 
+         * @return unsigned number of threads
+         */
+        unsigned size() const {return workers.size() + 1;}
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+    private:
+        std::vector<std::thread> workers;
+        std::mutex lock;
+        std::condition_variable wake;           // a job was posted, or the pool is stopping
+        std::condition_variable done;           // every worker finished the job
+        const std::function<void(size_t)> *job = NULL;
+        size_t jobSize = 0;                     // number of tasks in the job
+        std::atomic<size_t> next{0};            // next task to be taken
+        size_t busy = 0;                        // workers still on the job
+        uint64_t posted = 0;                    // jobs posted so far
+        bool stopping = false;
+
+        /**
+         * @brief Take tasks of the current job until none are left
+         * 
+         */
+        void drain();
+
+        /**
+         * @brief Wait for jobs, and work on each of them
+         * 
+         */
+        void work();
+};
+
+#endif
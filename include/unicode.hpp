@@ -0,0 +1,79 @@
+#ifndef UNICODE_HPP
+#define UNICODE_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <string_view>
+#include "cell.hpp"
+
+// code point put in for malformed UTF-8
+inline constexpr uint32_t REPLACEMENT_CHARACTER = 0xfffd;
+
+/**
+ * @brief Get the number of columns a code point takes on the console
+ * 
+ * Looked up in a table generated from the Unicode data by `tools/widths.py`.
+ * 
+ * @param cp Code point
+ * @return uint32_t 2 for wide characters, 0 for controls and marks joining
+ *         the character before them, 1 otherwise
+ */
+uint32_t glyphWidth(uint32_t cp);
+
+/**
+ * @brief Decode the code point starting at a position of a UTF-8 text
+ * 
+ * @param text Text to be decoded
+ * @param pos Position of the first byte, moved past the code point
+ * @return uint32_t code point, or `REPLACEMENT_CHARACTER` for a malformed sequence
+ */
+uint32_t decodeUtf8(std::string_view text, size_t &pos);
+
+/**
+ * @brief Encode a code point as UTF-8
+ * 
+ * @param cp Code point
+ * @param out Buffer of at least 4 bytes
+ * @return size_t number of bytes written
+ */
+size_t encodeUtf8(uint32_t cp, char *out);
+
+/**
+ * @brief Get the number of bytes a code point takes in UTF-8
+ * 
+ * @param cp Code point
+ * @return size_t 1 to 4
+ */
+inline size_t utf8Length(uint32_t cp) {return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;}
+
+/**
+ * @brief Check whether a text is printable ASCII, one byte to a column
+ * 
+ * @param text Text to be checked
+ * @return true if every byte is a printable ASCII character
+ */
+bool isPlainText(std::string_view text);
+
+/**
+ * @brief Get the number of columns a UTF-8 text takes on the console
+ * 
+ * @param text Text to be measured
+ * @return uint32_t sum of the widths of its code points
+ */
+uint32_t textWidth(std::string_view text);
+
+/**
+ * @brief Lay out a UTF-8 text, one glyph to a column
+ * 
+ * Wide characters are followed by `WIDE_CONTINUATION`, and code points
+ * taking no column are dropped, except newlines, which are kept in a
+ * column of their own.
+ * 
+ * @param text Text to be laid out
+ * @param glyphs Set to the glyphs, one per column
+ */
+void layoutText(std::string_view text, std::vector<uint32_t> &glyphs);
+
+#endif
@@ -0,0 +1,1820 @@
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <new>
+#include "../include/frame.hpp"
+#include "../include/raster.hpp"
+
+static Rect intersectRect(Rect a, Rect b)
+{
+    Rect r;
+    r.left = std::max(a.left, b.left);
+    r.top = std::max(a.top, b.top);
+    r.right = std::min(a.right, b.right);
+    r.bottom = std::min(a.bottom, b.bottom);
+    return r;
+}
+
+static bool isEmptyRect(Rect r) {return r.left >= r.right || r.top >= r.bottom;}
+
+static Rect boxRect(CMDBox *box)
+{
+    int x = box->getX(), y = box->getY();
+    return {x, y, (int)(x + box->width), (int)(y + box->height)};
+}
+
+static Rect unionRect(Rect a, Rect b)
+{
+    if (isEmptyRect(a)) return b;
+    if (isEmptyRect(b)) return a;
+
+    Rect r;
+    r.left = std::min(a.left, b.left);
+    r.top = std::min(a.top, b.top);
+    r.right = std::max(a.right, b.right);
+    r.bottom = std::max(a.bottom, b.bottom);
+    return r;
+}
+
+static bool containsRect(Rect outer, Rect inner)
+{
+    return outer.left <= inner.left && outer.top <= inner.top &&
+           outer.right >= inner.right && outer.bottom >= inner.bottom;
+}
+
+static long rectArea(Rect r) {return isEmptyRect(r) ? 0 : (long)(r.right - r.left) * (r.bottom - r.top);}
+
+// frames only track the topmost opaque children covering a sizeable share of the painted area,
+// such as dialogs and panels, as smaller ones rarely hide anything and cost a check per box
+static const size_t MAX_OCCLUDERS = 4;
+static const long OCCLUDER_SHARE = 8;
+
+// whether a run of cells on one row may touch an area
+static bool overlapsRun(Rect area, uint32_t x, uint32_t y, uint32_t len)
+{
+    return (int64_t)y >= area.top && (int64_t)y < area.bottom &&
+           (int64_t)x + len > area.left && (int64_t)x < area.right;
+}
+
+// frames rendered on several threads are split into bands of at least this many rows
+static const uint32_t MIN_BAND_ROWS = 8;
+
+// unchanged cells between two runs are never written again past this many, as no move along a row costs as much
+static const int MAX_BRIDGE = 16;
+
+// code points below this are never wide
+static const uint32_t FIRST_WIDE = 0x1100;
+
+static size_t glyphBytes(Cell cell)
+{
+    uint32_t glyph = cellGlyph(cell);
+    return glyph == WIDE_CONTINUATION ? 0 : utf8Length(glyph);
+}
+
+static bool isWideGlyph(uint32_t glyph)
+{
+    return glyph >= FIRST_WIDE && glyph != WIDE_CONTINUATION && glyphWidth(glyph) == 2;
+}
+
+// turn the holes of a composited row into blanks, and blank the halves of wide characters
+// that the boxes above them cut apart
+static void settleRow(Cell *line, int left, int right, int width)
+{
+    for (int x = left; x < right; ++x)
+    {
+        uint32_t glyph = cellGlyph(line[x]);
+        if (glyph == 0) line[x] = makeCell(' ');
+        else if (glyph < FIRST_WIDE) continue;
+        else if (glyph == WIDE_CONTINUATION)
+        {
+            if (x == 0 || !isWideGlyph(cellGlyph(line[x - 1]))) line[x] = makeCell(' ', cellStyle(line[x]));
+        }
+        else if (isWideGlyph(glyph))
+        {
+            if (x + 1 == width || cellGlyph(line[x + 1]) != WIDE_CONTINUATION) line[x] = makeCell(' ', cellStyle(line[x]));
+        }
+    }
+}
+
+// bring the cached position, bounds and text lines of a box and all of its contents up to date
+static void refreshCaches(CMDBox *box)
+{
+    box->getX();
+    box->getBounds();
+    box->getTextLines();
+    box->forEachChild([](CMDBox *child) {refreshCaches(child);});
+}
+
+typedef struct Occluder {
+    Rect area;                          // area covered, within the clip
+    size_t depth;                       // children in front of it
+} Occluder;
+
+static bool isOccluded(Rect area, size_t depth, const Occluder *occluders, size_t count)
+{
+    // only areas hidden entirely by one box in front of them are culled
+    for (size_t i = 0; i < count; ++i)
+        if (occluders[i].depth < depth && containsRect(occluders[i].area, area)) return true;
+    return false;
+}
+
+typedef struct alignas(std::max_align_t) AllocHeader {
+    NodePool *pool;                     // pool the box came from, or NULL for the heap
+    size_t size;                        // bytes allocated, including the header
+} AllocHeader;
+
+// boxes allocated by operator new whose constructor has not run yet, innermost last
+// only their headers are read, as a box built anywhere else has none
+static thread_local std::vector<void*> unclaimed;
+
+static void forgetAllocation(void *p)
+{
+    auto it = std::find(unclaimed.rbegin(), unclaimed.rend(), p);
+    if (it != unclaimed.rend()) unclaimed.erase(std::next(it).base());
+}
+
+void* CMDBox::operator new(size_t size) {return operator new(size, (NodePool*)NULL);}
+
+void* CMDBox::operator new(size_t size, NodePool *pool)
+{
+    size += sizeof(AllocHeader);
+    void *p = (pool != NULL) ? pool->allocate(size, alignof(AllocHeader)) : ::operator new(size);
+
+    auto header = (AllocHeader*)p;
+    header->pool = pool;
+    header->size = size;
+
+    unclaimed.push_back(header + 1);
+    return header + 1;
+}
+
+void* CMDBox::operator new(size_t, void *place) {return place;}
+
+void CMDBox::operator delete(void *p)
+{
+    // a constructor that threw never claimed the allocation
+    if (p == NULL) return;
+    forgetAllocation(p);
+
+    auto header = (AllocHeader*)p - 1;
+    if (header->pool != NULL) header->pool->deallocate(header, header->size, alignof(AllocHeader));
+    else ::operator delete(header);
+}
+
+void CMDBox::operator delete(void *p, NodePool*) {operator delete(p);}
+
+void CMDBox::operator delete(void*, void*) {}
+
+void CMDBox::claimAllocation()
+{
+    // boxes built on the stack, in place or as members were allocated by nothing
+    auto it = std::find(unclaimed.rbegin(), unclaimed.rend(), (void*)this);
+    if (it == unclaimed.rend()) return;
+    unclaimed.erase(std::next(it).base());
+    pool = ((AllocHeader*)this - 1)->pool;
+}
+
+NodePool* CMDBox::getPool()
+{
+    if (pool == NULL)
+    {
+        pool = NodePool::create();
+        ownsPool = true;
+    }
+    return pool;
+}
+
+CMDBox::~CMDBox()
+{
+    detach();
+    if (ownsPool) pool->release();
+}
+
+void CMDBox::detach()
+{
+    // the frame gives up ownership too, as the box is already going
+    auto frame = dynamic_cast<CMDFrame*>(parent);
+    if (frame != NULL) frame->removeChild(this).release();
+}
+
+CMDFrame::~CMDFrame()
+{
+    stopTrace();
+    setStatsEnabled(false);
+
+    // leaving the parent while still a whole frame takes the contents out of the name index too
+    detach();
+
+    // children the frame does not own belong to someone else
+    for (auto &c_set : levels)
+    {
+        for (auto box : c_set.members)
+        {
+            box->parent = NULL;
+            if (box->isOwned()) delete box;
+            else leaveTree(box);
+        }
+    }
+}
+
+Indexing& CMDFrame::levelFor(int zindex)
+{
+    // levels are sorted from highest to lowest
+    auto level = std::lower_bound(levels.begin(), levels.end(), zindex,
+                                  [](const Indexing &l, int z) {return l.zindex > z;});
+    if (level != levels.end() && level->zindex == zindex) return *level;
+
+    // reuse the member list of a level that emptied out, if there is one
+    std::pmr::vector<CMDBox*> members(resource());
+    if (!spareLevels.empty())
+    {
+        members = std::move(spareLevels.back());
+        spareLevels.pop_back();
+    }
+    return *levels.insert(level, Indexing{zindex, std::move(members)});
+}
+
+bool CMDFrame::unlinkChild(CMDBox *child)
+{
+    auto level = std::lower_bound(levels.begin(), levels.end(), child->zindex,
+                                  [](const Indexing &l, int z) {return l.zindex > z;});
+    if (level == levels.end() || level->zindex != child->zindex) return false;
+
+    auto it = std::find(level->members.begin(), level->members.end(), child);
+    if (it == level->members.end()) return false;
+    level->members.erase(it);
+
+    // empty levels are kept aside for the next new z-index
+    if (level->members.empty())
+    {
+        spareLevels.push_back(std::move(level->members));
+        levels.erase(level);
+    }
+    return true;
+}
+
+CMDGrid::~CMDGrid()
+{
+    detach();
+    for (uint32_t y = 0; y < rows.count; ++y)
+        for (uint32_t x = 0; x < columns.count; ++x)
+            delete slot(y, x);
+    for (auto cell : retired) delete cell;
+}
+
+void CMDBox::shift(int x, int y) {
+    if ((int64_t)getX() + x >= 0 && (int64_t)getY() + y >= 0) {
+        // descendants are placed relative to the box, so they follow it
+        damage();
+        offx += x; offy += y;
+        moved();
+        if (parent != NULL) parent->invalidateBounds();
+        damage();
+    } else throw std::runtime_error("out of range");
+}
+
+void CMDBox::setBorder(uint32_t ch)
+{
+    borders.topleft = ch;
+    borders.topright = ch;
+    borders.botmleft = ch;
+    borders.botmright = ch;
+
+    borders.topbody = ch;
+    borders.botmbody = ch;
+    borders.leftbody = ch;
+    borders.rightbody = ch;
+    damage();
+}
+
+void CMDGrid::setBorder(uint32_t ch)
+{
+    tableborderch = ch;
+    damage();
+}
+
+void CMDBox::setStyle(Style st)
+{
+    style = st;
+    damage();
+}
+
+void CMDBox::setBorderStyle(Style st)
+{
+    borderStyle = st;
+    damage();
+}
+
+void CMDBox::setZIndex(int zindex)
+{
+    auto tp = dynamic_cast<CMDFrame*>(parent);
+    if (tp != NULL) tp->setChildZIndex(this, zindex);
+}
+
+void CMDFrame::setChildZIndex(CMDBox *child, int zindex)
+{
+    if (child->parent != this || child->zindex == zindex) return;
+
+    // the child keeps its place in the tree, so only its level changes
+    if (unlinkChild(child))
+    {
+        child->zindex = zindex;
+        levelFor(zindex).members.push_back(child);
+        invalidateBounds();
+        child->damage();
+    }
+}
+
+void CMDBox::setPosition(uint32_t x, uint32_t y, bool isRelative)
+{
+    damage();
+    offx = (isRelative || parent == NULL) ? (int32_t)x : (int32_t)x - (int32_t)parent->getX();
+    offy = (isRelative || parent == NULL) ? (int32_t)y : (int32_t)y - (int32_t)parent->getY();
+    moved();
+    if (parent != NULL) parent->invalidateBounds();
+    damage();
+}
+
+void CMDBox::setSize(uint32_t wid, uint32_t hig)
+{
+    if (width == wid && height == hig) return;
+
+    // the area left behind needs to be redisplayed too
+    damage();
+    width = wid;
+    height = hig;
+    invalidateBounds();
+    breakLines();
+    damage();
+}
+
+void CMDBox::refreshPosition()
+{
+    if (absGeneration == *treeMoves) return;
+
+    // parents refresh themselves first, so each box is recomputed once per move
+    int64_t x = offx, y = offy;
+    if (parent != NULL)
+    {
+        x += parent->getX();
+        y += parent->getY();
+    }
+    absx = (uint32_t)std::max<int64_t>(x, 0);
+    absy = (uint32_t)std::max<int64_t>(y, 0);
+    absGeneration = *treeMoves;
+}
+
+void CMDBox::joinTree(CMDBox *box, uint64_t *moves)
+{
+    // a position cached under the count of another tree may match this one by chance
+    box->treeMoves = moves;
+    box->absGeneration = 0;
+    box->forEachChild([moves](CMDBox *child) {joinTree(child, moves);});
+}
+
+void CMDBox::setPosition(TextPosition pos)
+{
+    if (parent != NULL)
+    {
+        // the area left behind needs to be redisplayed too
+        damage();
+
+        // set position
+        boxPosition = pos;
+
+        // offsets are relative to the parent, so alignment is too
+        int xmin = 0;
+        int xmax = xmin + parent->width - 1;
+        int ymin = 0;
+        int ymax = ymin + parent->height - 1;
+
+        if (parent->bordered)
+        {
+            xmin += 1;
+            xmax -= 1;
+            ymin += 1;
+            ymax -= 1;
+        }
+
+        int xmid = ((xmax - xmin) / 2) + xmin + ((xmax - xmin) % 2);
+        int ymid = ((ymax - ymin) / 2) + ymin + ((ymax - ymin) % 2);
+
+        int tposy = ymin, tposx = xmin;
+        switch (pos)
+        {
+            case TRUE_CENTER:
+                tposy = ymid - height/2;
+                tposx = xmid - width/2;
+                break;
+
+            case CENTER_LEFT:
+                tposy = ymid - height/2;
+                tposx = xmin;
+                break;
+
+            case CENTER_RIGHT:
+                tposy = ymid - height/2;
+                tposx = xmax - width + 1;
+                break;
+
+            case TOP_CENTER:
+                tposy = ymin;
+                tposx = xmid - width/2;
+                break;
+
+            case TOP_LEFT:
+                tposy = ymin;
+                tposx = xmin;
+                break;
+
+            case TOP_RIGHT:
+                tposy = ymin;
+                tposx = xmax - width + 1;
+                break;
+                
+            case BOTTOM_CENTER:
+                tposy = ymax - height + 1;
+                tposx = xmid - width/2;
+                break;
+                
+            case BOTTOM_LEFT:
+                tposy = ymax - height + 1;
+                tposx = xmin;
+                break;
+                
+            case BOTTOM_RIGHT:
+                tposy = ymax - height + 1;
+                tposx = xmax - width + 1;
+                break;
+        }
+
+        // boxes pushed past the screen edge are clamped when read
+        offy = tposy;
+        offx = tposx;
+        moved();
+        parent->invalidateBounds();
+        damage();
+    }
+}
+
+void CMDBox::getTextOrigin(uint32_t len, size_t lines, int64_t &textx, int64_t &texty)
+{
+    int64_t minx = getX();
+    int64_t maxx = minx + width - 1;
+    int64_t miny = getY();
+    int64_t maxy = miny + height - 1;
+    int64_t inset = bordered ? 1 : 0;
+
+    // the text is aligned as a block vertically, and line by line horizontally
+    int64_t centerx = minx + width/2 - (int64_t)(len/2);
+    int64_t centery = miny + height/2 - (int64_t)(lines/2);
+    int64_t rightx = maxx + 1 - len - inset;
+    int64_t bottomy = maxy + 1 - (int64_t)lines - inset;
+
+    switch (textPosition)
+    {
+        case TRUE_CENTER:
+            texty = centery;
+            textx = centerx;
+            break;
+
+        case CENTER_LEFT:
+            texty = centery;
+            textx = minx + inset;
+            break;
+
+        case CENTER_RIGHT:
+            texty = centery;
+            textx = rightx;
+            break;
+
+        case TOP_CENTER:
+            texty = miny + inset;
+            textx = centerx;
+            break;
+
+        case TOP_LEFT:
+            texty = miny + inset;
+            textx = minx + inset;
+            break;
+
+        case TOP_RIGHT:
+            texty = miny + inset;
+            textx = rightx;
+            break;
+            
+        case BOTTOM_CENTER:
+            texty = bottomy;
+            textx = centerx;
+            break;
+            
+        case BOTTOM_LEFT:
+            texty = bottomy;
+            textx = minx + inset;
+            break;
+            
+        case BOTTOM_RIGHT:
+            texty = bottomy;
+            textx = rightx;
+            break;
+    }
+}
+
+uint32_t CMDBox::getCharIn(uint32_t x, uint32_t y)
+{
+    return cellGlyph(getCellIn(x, y));
+}
+
+Cell CMDBox::getCellIn(uint32_t x, uint32_t y)
+{
+    // a run of a single cell
+    Cell cell = 0;
+    getSpan(x, y, 1, &cell);
+    return cell;
+}
+
+void CMDBox::getSpan(uint32_t x, uint32_t y, uint32_t len, Cell *out)
+{
+    if (!isVisible) return;
+
+    // empty boxes cover nothing
+    if (width == 0 || height == 0) return;
+
+    // only the part of the run covered by the box is written
+    int64_t minx = getX();
+    int64_t maxx = minx + width - 1;
+    int64_t miny = getY();
+    int64_t maxy = miny + height - 1;
+
+    if (y < miny || y > maxy) return;
+
+    int64_t left = std::max<int64_t>(x, minx);
+    int64_t right = std::min<int64_t>((int64_t)x + len, maxx + 1);
+    if (left >= right) return;
+    countSpan();
+
+    if (bordered)
+    {
+        // top and bottom edges are entirely border
+        if (y == miny || y == maxy)
+        {
+            uint32_t body = (y == miny) ? borders.topbody : borders.botmbody;
+            int64_t from = std::max(left, minx + 1), to = std::min(right, maxx);
+            if (body != 0 && from < to) fillRow(out + (from - x), makeCell(body, borderStyle), to - from);
+
+            // the left corner wins on a box one cell wide
+            uint32_t first = (y == miny) ? borders.topleft : borders.botmleft;
+            uint32_t last = (y == miny) ? borders.topright : borders.botmright;
+            if (right - 1 == maxx && last != 0) out[maxx - x] = makeCell(last, borderStyle);
+            if (left == minx && first != 0) out[minx - x] = makeCell(first, borderStyle);
+            return;
+        }
+
+        // left and right edges
+        if (left == minx)
+        {
+            if (borders.leftbody != 0) out[left - x] = makeCell(borders.leftbody, borderStyle);
+            left++;
+        }
+        if (right - 1 == maxx && right > left)
+        {
+            if (borders.rightbody != 0) out[right - 1 - x] = makeCell(borders.rightbody, borderStyle);
+            right--;
+        }
+    }
+
+    // background
+    if (!isTransparent && right > left)
+        fillRow(out + (left - x), makeCell(' ', style), right - left);
+
+    // text slice, from the line of the text on this row
+    const std::vector<TextLine> &lines = getTextLines();
+    int64_t textx = 0, texty = 0;
+    if (lines.empty()) return;
+    getTextOrigin(0, lines.size(), textx, texty);
+    if ((int64_t)y < texty || (int64_t)y - texty >= (int64_t)lines.size()) return;
+
+    const TextLine &line = lines[y - texty];
+    getTextOrigin(line.length, lines.size(), textx, texty);
+    int64_t from = std::max<int64_t>(textx, left);
+    int64_t to = std::min<int64_t>(textx + line.length, right);
+    if (from >= to) return;
+
+    size_t first = line.start + (from - textx), last = line.start + (to - textx);
+    if (textGlyphs.empty()) compositeText(out + (from - x), inner.data() + first, to - from, style);
+    else
+    {
+        compositeText(out + (from - x), textGlyphs.data() + first, to - from, style);
+
+        // wide characters cut in half by the edges of the box are left blank
+        int64_t inset = bordered ? 1 : 0;
+        if (from == minx + inset && textGlyphs[first] == WIDE_CONTINUATION) out[from - x] = makeCell(' ', style);
+        if (to == maxx + 1 - inset && last < line.start + line.length && textGlyphs[last] == WIDE_CONTINUATION)
+            out[to - 1 - x] = makeCell(' ', style);
+    }
+}
+
+void CMDFrame::getSpan(uint32_t x, uint32_t y, uint32_t len, Cell *out)
+{
+    // a single cell is looked up front to back, stopping at the topmost box covering it
+    if (len == 1)
+    {
+        for (auto &level : levels)
+        {
+            if (level.zindex < 0) break;
+            for (auto box : level.members)
+            {
+                if (!overlapsRun(box->getBounds(), x, y, 1)) continue;
+
+                countBoxVisits(1);
+                Cell cell = 0;
+                box->getSpan(x, y, 1, &cell);
+                if (cellGlyph(cell) != 0) { *out = cell; return; }
+            }
+        }
+        CMDBox::getSpan(x, y, 1, out);
+        return;
+    }
+
+    CMDBox::getSpan(x, y, len, out);
+
+    // levels are sorted from highest to lowest, and negative levels are hidden
+    uint64_t visits = 0;
+    for (auto level = levels.rbegin(); level != levels.rend(); ++level)
+    {
+        if (level->zindex < 0) continue;
+
+        // the first member of a level takes precedence, so it is composited last
+        for (auto box = level->members.rbegin(); box != level->members.rend(); ++box)
+        {
+            if (!overlapsRun((*box)->getBounds(), x, y, len)) continue;
+            (*box)->getSpan(x, y, len, out);
+            ++visits;
+        }
+    }
+    countBoxVisits(visits);
+}
+
+void CMDGrid::getSpan(uint32_t x, uint32_t y, uint32_t len, Cell *out)
+{
+    // grids in the middle of a batch are drawn as last laid out, and empty ones cover nothing
+    if (width == 0 || height == 0 || placed.empty()) return;
+
+    int64_t minx = getX();
+    int64_t miny = getY();
+    if (y < miny || y >= miny + height) return;
+
+    int64_t left = std::max<int64_t>(x, minx);
+    int64_t right = std::min<int64_t>((int64_t)x + len, minx + width);
+    if (left >= right) return;
+    countSpan();
+
+    // table borders run along the whole row
+    int row = rowAt[y - miny];
+    if (row < 0)
+    {
+        if (tableborderch != 0) fillRow(out + (left - x), makeCell(tableborderch, borderStyle), right - left);
+        return;
+    }
+
+    // each cell composites the part of the run inside of it
+    uint64_t visits = 0;
+    for (int64_t c = left; c < right; )
+    {
+        int col = colAt[c - minx];
+        if (col < 0)
+        {
+            if (tableborderch != 0) out[c - x] = makeCell(tableborderch, borderStyle);
+            ++c;
+            continue;
+        }
+
+        int64_t end = std::min<int64_t>(right, minx + colStart[col + 1] - placedBorder);
+        placed[(size_t)row * placedColumns + col]->getSpan(c, y, end - c, out + (c - x));
+        c = end;
+        ++visits;
+    }
+    countBoxVisits(visits);
+}
+
+void CMDBox::paint(FrameBuffer &fb, Rect clip)
+{
+    // only the cells covered by both the box and the clip are written
+    Rect area = intersectRect(intersectRect(boxRect(this), clip), {0, 0, (int)fb.width, (int)fb.height});
+    if (isEmptyRect(area)) return;
+    countBoxVisits(1);
+
+    for (int y = area.top; y < area.bottom; ++y)
+        getSpan(area.left, y, area.right - area.left, fb.cells.data() + (size_t)y * fb.width + area.left);
+}
+
+void CMDFrame::paint(FrameBuffer &fb, Rect clip)
+{
+    clip = intersectRect(clip, {0, 0, (int)fb.width, (int)fb.height});
+    if (isEmptyRect(clip)) return;
+    countBoxVisits(1);
+
+    // the topmost opaque children large enough to hide others, found front to back; they are kept
+    // on the stack, as bands of one frame may be painted on several threads at once
+    Occluder occluders[MAX_OCCLUDERS];
+    size_t found = 0, total = 0;
+    for (auto &level : levels)
+    {
+        if (level.zindex < 0) break;
+        for (auto box : level.members)
+        {
+            if (found < MAX_OCCLUDERS && box->isOpaque())
+            {
+                Rect shown = intersectRect(boxRect(box), clip);
+                if (rectArea(shown) * OCCLUDER_SHARE >= rectArea(clip)) occluders[found++] = {shown, total};
+            }
+            total++;
+        }
+    }
+
+    // the frame itself lies below all of its children
+    Rect own = intersectRect(boxRect(this), clip);
+    if (isVisible && !isEmptyRect(own) && !isOccluded(own, total, occluders, found))
+    {
+        for (int y = own.top; y < own.bottom; ++y)
+            CMDBox::getSpan(own.left, y, own.right - own.left, fb.cells.data() + (size_t)y * fb.width + own.left);
+    }
+
+    // then the children, back to front; subtrees outside of the clip, or hidden, are not visited
+    size_t depth = total;
+    for (auto level = levels.rbegin(); level != levels.rend(); ++level)
+    {
+        if (level->zindex < 0) continue;
+        for (auto box = level->members.rbegin(); box != level->members.rend(); ++box)
+        {
+            --depth;
+            Rect bounds = intersectRect((*box)->getBounds(), clip);
+            if (isEmptyRect(bounds) || isOccluded(bounds, depth, occluders, found)) continue;
+            (*box)->paint(fb, clip);
+        }
+    }
+}
+
+void CMDFrame::updateDisplay(std::string_view elName)
+{
+    // update the display of a specific element
+    auto el = getElementByName(elName);
+
+    if (el != NULL) 
+    {
+        render(boxRect(el));
+        writeOutput();
+    }
+}
+
+void CMDFrame::updateDisplay(CMDBox* el)
+{
+    // update the display of a specific element
+    if (el != NULL && isParentTo(el)) 
+    {
+        render(boxRect(el));
+        writeOutput();
+    }
+}
+
+void CMDFrame::invalidateScreen()
+{
+    // no console cell is ever 0, so every cell is written again
+    std::fill(screen.begin(), screen.end(), 0);
+}
+
+void CMDFrame::render(Rect area)
+{
+    // a resized frame has nothing on screen yet
+    if (framebuffer.width != width || framebuffer.height != height)
+    {
+        framebuffer.width = width;
+        framebuffer.height = height;
+        framebuffer.cells.assign((size_t)width * height, 0);
+        screen.assign((size_t)width * height, 0);
+    }
+
+    area = intersectRect(area, {0, 0, (int)width, (int)height});
+    if (isEmptyRect(area)) return;
+
+    // wide characters straddling the edges of the area are painted whole
+    area = intersectRect({area.left - 1, area.top, area.right + 1, area.bottom}, {0, 0, (int)width, (int)height});
+
+    // composite every box once, back to front, in bands of rows on the render pool
+    uint64_t start = startFrame();
+    uint32_t rows = area.bottom - area.top;
+    size_t bands = (renderPool != NULL) ? std::min<size_t>(renderPool->size() * 2, rows / MIN_BAND_ROWS) : 1;
+    if (collecting) bandStats.assign(std::max<size_t>(bands, 1), {});
+    if (bands > 1)
+    {
+        // painting only reads the tree once every lazy cache is up to date; fields written
+        // directly change nothing a generation could tell, so the caches are refreshed every frame
+        refreshCaches(this);
+
+        renderPool->run(bands, [this, area, rows, bands](size_t i) {
+            Rect band = {area.left, area.top + (int)(rows * i / bands), area.right, area.top + (int)(rows * (i + 1) / bands)};
+            paintBand(band, i);
+        });
+    }
+    else paintBand(area, 0);
+
+    if (collecting)
+    {
+        uint64_t now = statClock();
+        stats.rasterNs += now - start;
+        for (auto &band : bandStats)
+        {
+            stats.spansPainted += band.counters.spansPainted;
+            stats.boxesVisited += band.counters.boxesVisited;
+        }
+
+        if (trace)
+        {
+            trace->span("raster", {start, now - start, statThread()});
+            for (auto &band : bandStats) trace->span("band", band.span);
+        }
+        start = now;
+    }
+
+    size_t changed = 0;
+    for (int y = area.top; y < area.bottom; ++y)
+    {
+        Cell *line = framebuffer.cells.data() + (size_t)y * width;
+        Cell *shown = screen.data() + (size_t)y * width;
+        settleRow(line, area.left, area.right, width);
+
+        // hand each run of changed cells to the sink at once
+        int x = area.left;
+        while (x < area.right)
+        {
+            if (line[x] == shown[x]) { ++x; continue; }
+
+            // wide characters are written whole
+            int first = x;
+            if (first > 0 && cellGlyph(line[first]) == WIDE_CONTINUATION) --first;
+            while (true)
+            {
+                for (; x < area.right && line[x] != shown[x]; ++x) ++changed;
+                if (x < (int)width && cellGlyph(line[x]) == WIDE_CONTINUATION) ++x;
+
+                // a short gap in the style of the run is written again when that is cheaper than moving over it
+                Style style = cellStyle(line[x - 1]);
+                int next = x;
+                size_t bytes = 0;
+                for (; next < area.right && next - x < MAX_BRIDGE && line[next] == shown[next] && cellStyle(line[next]) == style; ++next)
+                    bytes += glyphBytes(line[next]);
+                if (next >= area.right || line[next] == shown[next]) break;
+                if (bytes > sink->moveCost(getX() + x, getX() + next, getY() + y)) break;
+                x = next;
+            }
+
+            sink->writeRun(getX() + first, getY() + y, line + first, x - first);
+        }
+
+        blitRow(shown + area.left, line + area.left, area.right - area.left);
+    }
+
+    if (collecting)
+    {
+        uint64_t now = statClock();
+        stats.cellsChanged += changed;
+        stats.outputNs += now - start;
+        if (trace) trace->span("diff", {start, now - start, statThread()});
+    }
+}
+
+void CMDFrame::paintBand(Rect band, size_t index)
+{
+    // the counters of a band are kept apart from those of the thread painting it
+    StatCounters before = {0, 0, 0};
+    uint64_t start = 0;
+    if (collecting)
+    {
+        before = statCounters;
+        start = statClock();
+    }
+
+    for (int y = band.top; y < band.bottom; ++y)
+        fillRow(framebuffer.cells.data() + (size_t)y * width + band.left, 0, band.right - band.left);
+    paint(framebuffer, band);
+
+    if (collecting)
+    {
+        BandStats &out = bandStats[index];
+        out.span = {start, statClock() - start, statThread()};
+        out.counters = {statCounters.spansPainted - before.spansPainted, statCounters.boxesVisited - before.boxesVisited, 0};
+        statCounters = before;
+    }
+}
+
+void CMDFrame::setSink(RenderSink *target)
+{
+    sink = (target != NULL) ? target : &console;
+    invalidateScreen();
+}
+
+void CMDFrame::setStatsEnabled(bool enabled)
+{
+    // a trace needs the counters
+    if (!enabled && trace) return;
+    if (enabled == collecting) return;
+
+    collecting = enabled;
+    if (enabled) statsUsers++;
+    else statsUsers--;
+    stats = FrameStats();
+    frameStart = 0;
+}
+
+bool CMDFrame::startTrace(const std::string &path)
+{
+    stopTrace();
+
+    auto file = std::make_unique<TraceFile>();
+    if (!file->open(path)) return false;
+
+    setStatsEnabled(true);
+    trace = std::move(file);
+    return true;
+}
+
+void CMDFrame::stopTrace()
+{
+    if (!trace) return;
+    trace.reset();
+    layoutSpans.clear();
+}
+
+uint64_t CMDFrame::startFrame()
+{
+    if (!collecting) return 0;
+    uint64_t now = statClock();
+    if (frameStart == 0) frameStart = now;
+    return now;
+}
+
+void CMDFrame::writeOutput()
+{
+    if (!collecting)
+    {
+        sink->flush();
+        return;
+    }
+
+    uint64_t start = startFrame();
+    stats.bytesWritten = sink->flush();
+    uint64_t end = statClock();
+    stats.outputNs += end - start;
+
+    // calls and layouts on this thread since the previous frame belong to this one
+    stats.frame = lastStats.frame + 1;
+    stats.spansPainted += statCounters.spansPainted;
+    stats.boxesVisited += statCounters.boxesVisited;
+    stats.layoutNs = statCounters.layoutNs;
+    statCounters = {0, 0, 0};
+
+    if (trace)
+    {
+        for (auto &span : layoutSpans) trace->span("layout", span);
+        layoutSpans.clear();
+        trace->span("write", {start, end - start, statThread()});
+        trace->span("frame", {frameStart, end - frameStart, statThread()}, &stats);
+        trace->counters(end, stats);
+    }
+
+    lastStats = stats;
+    stats = FrameStats();
+    frameStart = 0;
+}
+
+void CMDFrame::addLayoutSpan(TraceSpan span)
+{
+    if (trace) layoutSpans.push_back(span);
+}
+
+void CMDFrame::setRenderPool(ThreadPool *pool)
+{
+    renderPool = pool;
+}
+
+CMDBox* CMDBox::getElementByName(std::string_view nom)
+{
+    if (name == nom) return this;
+    else return NULL;
+}
+
+CMDBox* CMDFrame::getElementByName(std::string_view nom)
+{
+    if (CMDBox::getElementByName(nom) != NULL) return this;
+
+    // unnamed boxes are not indexed
+    auto root = getRootFrame();
+    if (root != NULL && !nom.empty()) return root->findName(nom, this);
+
+    for (auto &c_set : levels)
+    {
+        for (auto box : c_set.members) 
+        {
+            auto res = box->getElementByName(nom);
+            if (res != NULL) return res;
+        }
+    }
+
+    return NULL;
+}
+
+CMDBox* CMDGrid::getElementByName(std::string_view nom)
+{
+    if (CMDBox::getElementByName(nom) != NULL) return this;
+
+    auto root = getRootFrame();
+    if (root != NULL && !nom.empty()) return root->findName(nom, this);
+
+    for (uint32_t y = 0; y < rows.count; ++y)
+    {
+        for (uint32_t x = 0; x < columns.count; ++x)
+        {
+            auto cell = at(x, y);
+            auto res = cell->getElementByName(nom);
+            if (res != NULL) return res;
+        }
+    }
+
+    return NULL;
+}
+
+void CMDBox::setName(std::string nom)
+{
+    auto root = getRootFrame();
+    if (root != NULL && root != this) root->unindexNames(this);
+    name = nom;
+    if (root != NULL && root != this) root->indexNames(this);
+}
+
+void CMDFrame::forEachChild(const std::function<void(CMDBox*)> &fn)
+{
+    for (auto &c_set : levels)
+    {
+        for (auto box : c_set.members) fn(box);
+    }
+}
+
+void CMDGrid::forEachChild(const std::function<void(CMDBox*)> &fn)
+{
+    for (uint32_t y = 0; y < rows.count; ++y)
+    {
+        for (uint32_t x = 0; x < columns.count; ++x) fn(slot(y, x));
+    }
+}
+
+void CMDFrame::indexNames(CMDBox *box)
+{
+    if (!box->getName().empty()) names.emplace(box->getName(), box);
+    box->forEachChild([this](CMDBox *child) {indexNames(child);});
+}
+
+void CMDFrame::unindexNames(CMDBox *box)
+{
+    if (!box->getName().empty())
+    {
+        auto range = names.equal_range(std::string_view(box->getName()));
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == box)
+            {
+                names.erase(it);
+                break;
+            }
+        }
+    }
+    box->forEachChild([this](CMDBox *child) {unindexNames(child);});
+}
+
+// depth-first search of the contents of a box, in the order they are kept, without the name index
+static CMDBox* firstNamed(CMDBox *box, std::string_view nom)
+{
+    CMDBox *found = NULL;
+    box->forEachChild([&found, nom](CMDBox *child) {
+        if (found != NULL) return;
+        if (child->getName() == nom) found = child;
+        else found = firstNamed(child, nom);
+    });
+    return found;
+}
+
+CMDBox* CMDFrame::findName(std::string_view nom, CMDBox *within)
+{
+    CMDBox *match = NULL;
+    auto range = names.equal_range(nom);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        // walk up from the match, since only the contents of `within` count
+        for (auto box = it->second->parent; box != NULL; box = box->parent)
+        {
+            if (box != within) continue;
+
+            // the index keeps no order, so a shared name is looked up the slow way
+            if (match != NULL) return firstNamed(within, nom);
+            match = it->second;
+            break;
+        }
+    }
+
+    return match;
+}
+
+bool CMDBox::isParentTo(CMDBox* addr) {return this == addr;}
+
+bool CMDFrame::isParentTo(CMDBox* addr)
+{
+    if (addr == NULL) return false;
+    if (this == addr) return true;
+
+    for (auto &c_set : levels)
+    {
+        for (auto box : c_set.members) 
+        {
+            if (box == addr) return true;
+            if (box->isParentTo(addr)) return true;
+        }
+    }
+
+    return false;
+}
+
+bool CMDGrid::isParentTo(CMDBox* addr)
+{
+    if (addr == NULL) return false;
+    if (this == addr) return true;
+
+    for (uint32_t y = 0; y < rows.count; ++y)
+    {
+        for (uint32_t x = 0; x < columns.count; ++x)
+        {
+            if (at(x, y)->isParentTo(addr)) return true;
+        }
+    }
+
+    return false;
+}
+
+void CMDBox::setText(std::string text)
+{
+    inner = text;
+    measureText();
+    damage();
+}
+
+void CMDBox::measureText()
+{
+    // plain ASCII is drawn straight from `inner`, one byte to a column
+    if (isPlainText(inner))
+    {
+        textColumns = inner.size();
+        textGlyphs.clear();
+    }
+    else
+    {
+        layoutText(inner, textGlyphs);
+        textColumns = textGlyphs.size();
+    }
+    breakLines();
+}
+
+const std::vector<TextLine>& CMDBox::getTextLines()
+{
+    // the breaks only depend on the text and the width inside the borders
+    uint32_t inset = bordered ? 2 : 0;
+    if (wrapWidth != (width > inset ? width - inset : 0)) breakLines();
+    return textLines;
+}
+
+void CMDBox::breakLines()
+{
+    uint32_t inset = bordered ? 2 : 0;
+    wrapWidth = width > inset ? width - inset : 0;
+    textLines.clear();
+    if (wrapWidth == 0) return;
+
+    // plain ASCII is broken straight from `inner`
+    auto glyphAt = [this](uint32_t i) -> uint32_t {return textGlyphs.empty() ? (unsigned char)inner[i] : textGlyphs[i];};
+
+    for (uint32_t start = 0; ; )
+    {
+        uint32_t end = start;
+        while (end < textColumns && glyphAt(end) != '\n') ++end;
+
+        // the line is wrapped at its last space that fits, or cut if there is none
+        bool wrapped = false;
+        while (end - start > wrapWidth)
+        {
+            wrapped = true;
+            uint32_t cut = start + wrapWidth;
+            if (glyphAt(cut) == WIDE_CONTINUATION) --cut;
+
+            // a wide character wider than the box is given a line of its own
+            if (cut == start)
+            {
+                textLines.push_back({start, 2});
+                start += 2;
+                continue;
+            }
+
+            uint32_t space = cut;
+            while (space > start && glyphAt(space) != ' ') --space;
+            uint32_t tail = space;
+            while (tail > start && glyphAt(tail - 1) == ' ') --tail;
+            if (tail == start)
+            {
+                textLines.push_back({start, cut - start});
+                start = cut;
+                continue;
+            }
+
+            textLines.push_back({start, tail - start});
+            start = space;
+            while (start < end && glyphAt(start) == ' ') ++start;
+        }
+        if (!wrapped || start < end) textLines.push_back({start, end - start});
+
+        if (end == textColumns) break;
+        start = end + 1;
+    }
+}
+
+Rect CMDBox::getBounds()
+{
+    int x = getX(), y = getY();
+    if (!boundsValid)
+    {
+        bool cacheable = true;
+        Rect bounds = computeBounds(cacheable);
+        if (!cacheable) return bounds;
+
+        boundsCache = {bounds.left - x, bounds.top - y, bounds.right - x, bounds.bottom - y};
+        boundsValid = true;
+    }
+    return {boundsCache.left + x, boundsCache.top + y, boundsCache.right + x, boundsCache.bottom + y};
+}
+
+void CMDBox::invalidateBounds()
+{
+    // holders of a box with outdated bounds are always outdated too, so the walk stops there
+    for (CMDBox *box = this; box != NULL && box->boundsValid; box = box->parent)
+        box->boundsValid = false;
+}
+
+Rect CMDBox::computeBounds(bool &) {return boxRect(this);}
+
+bool CMDBox::isOpaque()
+{
+    if (!isVisible || isTransparent || width == 0 || height == 0) return false;
+    if (!bordered) return true;
+
+    // a border character of 0 leaves the cell below showing
+    return borders.topleft != 0 && borders.topright != 0 && borders.botmleft != 0 && borders.botmright != 0 &&
+           borders.topbody != 0 && borders.botmbody != 0 && borders.leftbody != 0 && borders.rightbody != 0;
+}
+
+Rect CMDFrame::computeBounds(bool &cacheable)
+{
+    // children are not clipped to the frame, so they may lie outside of it
+    Rect bounds = boxRect(this);
+    for (auto &c_set : levels)
+    {
+        if (c_set.zindex < 0) break;
+        for (auto box : c_set.members)
+        {
+            bounds = unionRect(bounds, box->getBounds());
+
+            // boxes left of or above the frame may be held at the screen edge, which moves them relative to it
+            if (box->offx < 0 || box->offy < 0 || !box->hasCachedBounds()) cacheable = false;
+        }
+    }
+    return bounds;
+}
+
+CMDFrame* CMDBox::getRootFrame()
+{
+    CMDBox *top = this;
+    while (top->parent != NULL) top = top->parent;
+    return dynamic_cast<CMDFrame*>(top);
+}
+
+void CMDBox::beginUpdate()
+{
+    // the area before the batch is recorded once, up front
+    if (updateDepth == 0) damage();
+    updateDepth++;
+}
+
+void CMDBox::commitUpdate()
+{
+    if (updateDepth == 0) return;
+    if (--updateDepth > 0) return;
+
+    // a batch inside another one leaves its layouts to the outer batch
+    auto outer = openBatch();
+    if (outer != NULL)
+    {
+        outer->batchLayoutPending = outer->batchLayoutPending || batchLayoutPending;
+        batchLayoutPending = false;
+        return;
+    }
+
+    if (batchLayoutPending)
+    {
+        batchLayoutPending = false;
+        layoutDeferred(this);
+    }
+    damage();
+}
+
+CMDBox* CMDBox::openBatch()
+{
+    CMDBox *batch = NULL;
+    for (CMDBox *box = this; box != NULL; box = box->parent)
+        if (box->updateDepth > 0) batch = box;
+    return batch;
+}
+
+void CMDBox::layoutDeferred(CMDBox *box)
+{
+    if (box->layoutPending)
+    {
+        box->layoutPending = false;
+        box->layout();
+    }
+    box->forEachChild([](CMDBox *child) {layoutDeferred(child);});
+}
+
+void CMDBox::requestLayout()
+{
+    // the outermost batch lays out its boxes when it is committed
+    auto batch = openBatch();
+    if (batch == NULL)
+    {
+        layout();
+        return;
+    }
+    layoutPending = true;
+    batch->batchLayoutPending = true;
+}
+
+void CMDBox::layout()
+{
+    // only timed while some frame collects counters
+    if (statsUsers == 0)
+    {
+        applyLayout();
+        return;
+    }
+
+    uint64_t start = statClock();
+    applyLayout();
+    uint64_t duration = statClock() - start;
+    statCounters.layoutNs += duration;
+
+    // the trace of the tree the box is in shows the layout
+    auto root = getRootFrame();
+    if (root != NULL) root->addLayoutSpan({start, duration, statThread()});
+}
+
+void CMDBox::damage()
+{
+    // batches record their damage, covering everything under them, when they begin and when they are committed
+    CMDBox *top = this;
+    for (;; top = top->parent)
+    {
+        if (top->updateDepth > 0) return;
+        if (top->parent == NULL) break;
+    }
+
+    auto root = dynamic_cast<CMDFrame*>(top);
+    if (root != NULL) root->addDamage(getBounds());
+}
+
+void CMDFrame::addDamage(Rect area)
+{
+    // only the part of the area that is on screen matters
+    area = intersectRect(area, {0, 0, (int)width, (int)height});
+    if (isEmptyRect(area)) return;
+
+    for (size_t i = 0; i < damaged.size(); )
+    {
+        if (containsRect(damaged[i], area)) return;
+        Rect merged = unionRect(damaged[i], area);
+
+        // merge with any area it overlaps or touches, if that does not add cells
+        bool touches = !isEmptyRect(intersectRect({area.left - 1, area.top - 1, area.right + 1, area.bottom + 1}, damaged[i]));
+        if (containsRect(area, damaged[i]) ||
+            (touches && rectArea(merged) <= rectArea(area) + rectArea(damaged[i])))
+        {
+            area = merged;
+            damaged.erase(damaged.begin() + i);
+            i = 0;
+        }
+        else ++i;
+    }
+
+    damaged.push_back(area);
+
+    // too many scattered areas are cheaper to redisplay as one
+    if (damaged.size() > 32)
+    {
+        Rect bounds = damaged[0];
+        for (auto rect : damaged) bounds = unionRect(bounds, rect);
+        damaged.assign(1, bounds);
+    }
+}
+
+void CMDFrame::flush()
+{
+    // a resized frame needs to be displayed in full
+    if (framebuffer.width != width || framebuffer.height != height)
+    {
+        display();
+        return;
+    }
+
+    for (auto area : damaged) render(area);
+    damaged.clear();
+    writeOutput();
+}
+
+void CMDFrame::display() 
+{
+    damaged.clear();
+    render({0, 0, (int)width, (int)height});
+
+    // leave the cursor below the frame
+    sink->moveCursor(0, getY() + height);
+    writeOutput();
+}
+
+std::unique_ptr<CMDBox> CMDFrame::removeChild(CMDBox* child)
+{
+    if (child != NULL && child->parent == this) 
+    {
+        if (unlinkChild(child)) {
+            child->damage();
+
+            auto root = getRootFrame();
+            if (root != NULL) root->unindexNames(child);
+
+            // the child stays where it is on the screen
+            child->offx = child->getX();
+            child->offy = child->getY();
+            child->parent = NULL;
+            leaveTree(child);
+            moved();
+            invalidateBounds();
+
+            // layouts deferred by a batch the child has left are done now
+            if (child->openBatch() == NULL) layoutDeferred(child);
+
+            // a detached frame becomes the root of its own subtree
+            auto frame = dynamic_cast<CMDFrame*>(child);
+            if (frame != NULL)
+            {
+                frame->names.clear();
+                frame->forEachChild([frame](CMDBox *box) {frame->indexNames(box);});
+            }
+
+            // ownership passes back to the caller
+            if (child->isOwned())
+            {
+                setOwned(child, false);
+                return std::unique_ptr<CMDBox>(child);
+            }
+        }
+    }
+    return NULL;
+}
+
+void CMDFrame::addChild(CMDBox *child, int zindex) 
+{
+    // a child moved from another frame leaves it first, taking its owner along
+    auto from = dynamic_cast<CMDFrame*>(child->parent);
+    if (from != NULL)
+    {
+        bool wasOwned = child->isOwned();
+        from->removeChild(child).release();
+        setOwned(child, wasOwned);
+    }
+
+    // the child stays where it is on the screen, until it is positioned in the frame
+    child->offx = (int32_t)child->getX() - (int32_t)getX();
+    child->offy = (int32_t)child->getY() - (int32_t)getY();
+    child->parent = this;
+    joinTree(child, treeMoves);
+    moved();
+    invalidateBounds();
+    child->damage();
+
+    // a frame that is no longer a root has nothing left to flush or index
+    auto frame = dynamic_cast<CMDFrame*>(child);
+    if (frame != NULL)
+    {
+        frame->damaged.clear();
+        frame->names.clear();
+    }
+
+    auto root = getRootFrame();
+    if (root != NULL) root->indexNames(child);
+
+    child->zindex = zindex;
+    levelFor(zindex).members.push_back(child);
+}
+
+void CMDGrid::addRow()
+{
+    rows.count++;
+    rows.rowheight.push_back(0);
+    
+    // the new row goes at the end of the block
+    cells.resize((size_t)rows.count * stride, NULL);
+    for (uint32_t x = 0; x < columns.count; ++x) 
+    {
+        auto nFrame = new (getPool()) CMDFrame("", columns.colwidth[x], rows.rowheight[rows.count-1]);
+        nFrame->parent = this;
+        joinTree(nFrame, treeMoves);
+        slot(rows.count-1, x) = nFrame;
+    }
+
+    requestLayout(rows.count - 1, NO_CHANGE, false);
+    damage();
+}
+
+void CMDGrid::addColumn()
+{
+    // rows have spare slots for new columns, and double their room when full
+    if (columns.count == stride)
+    {
+        uint32_t nstride = std::max<uint32_t>(4, stride * 2);
+        std::vector<CMDFrame*> ncells((size_t)rows.count * nstride, NULL);
+        for (uint32_t y = 0; y < rows.count; ++y)
+            std::copy(cells.begin() + (size_t)y * stride, cells.begin() + (size_t)y * stride + columns.count,
+                      ncells.begin() + (size_t)y * nstride);
+        cells.swap(ncells);
+        stride = nstride;
+    }
+
+    columns.count++;
+    columns.colwidth.push_back(0);
+
+    for (uint32_t y = 0; y < rows.count; ++y)
+    {
+        auto nFrame = new (getPool()) CMDFrame("", columns.colwidth[columns.count-1], rows.rowheight[y]);
+        nFrame->parent = this;
+        joinTree(nFrame, treeMoves);
+        slot(y, columns.count-1) = nFrame;
+    }
+
+    requestLayout(NO_CHANGE, columns.count - 1, false);
+    damage();
+}
+
+void CMDGrid::deleteRow(uint32_t row)
+{
+    if (row < rows.count)
+    {
+        damage();
+
+        // deleted cells take their contents out of the name index
+        auto root = getRootFrame();
+        if (root != NULL)
+            for (uint32_t i = 0; i < columns.count; ++i) root->unindexNames(slot(row, i));
+
+        // delete all column entries in row, once the last layout no longer draws them
+        for (uint32_t i = 0; i < columns.count; ++i)
+            retired.push_back(slot(row, i));
+        // delete row, moving the rows below up in one go
+        cells.erase(cells.begin() + (size_t)row * stride, cells.begin() + (size_t)(row + 1) * stride);
+
+        // adjust row count
+        rows.count--;
+        // delete records of rowheight in rows
+        rows.rowheight.erase(rows.rowheight.begin() + row);
+
+        // adjust height and posy for remaining entries
+        requestLayout(row, NO_CHANGE, false);
+    }
+}
+
+void CMDGrid::deleteColumn(uint32_t col)
+{
+    if (col < columns.count)
+    {
+        damage();
+
+        // deleted cells take their contents out of the name index
+        auto root = getRootFrame();
+        if (root != NULL)
+            for (uint32_t i = 0; i < rows.count; ++i) root->unindexNames(slot(i, col));
+
+        // delete column entries at col in all rows, closing the gap within each row
+        // the last layout draws them until it is replaced
+        for (uint32_t y = 0; y < rows.count; ++y)
+        {
+            auto row = cells.begin() + (size_t)y * stride;
+            retired.push_back(row[col]);
+            std::copy(row + col + 1, row + columns.count, row + col);
+            row[columns.count - 1] = NULL;
+        }
+
+        // adjust column count
+        columns.count--;
+        // delete records of colwidth in rows
+        columns.colwidth.erase(columns.colwidth.begin() + col);
+
+        // adjust width and posx for remaining entries
+        requestLayout(NO_CHANGE, col, false);
+    }
+}
+
+void CMDGrid::setHeight(uint32_t row, uint32_t hig)
+{
+    if (row < rows.count)
+    {
+        damage();
+
+        // update record, then the height of the grid and the rows from here down
+        // the position of the grid is adjusted again, as the height changed
+        rows.rowheight[row] = hig;
+        requestLayout(row, NO_CHANGE, true);
+        damage();
+    }
+}
+
+void CMDGrid::setWidth(uint32_t col, uint32_t wid)
+{
+    if (col < columns.count)
+    {
+        damage();
+
+        // update record, then the width of the grid and the columns from here right
+        // the position of the grid is adjusted again, as the width changed
+        columns.colwidth[col] = wid;
+        requestLayout(NO_CHANGE, col, true);
+        damage();
+    }
+}
+
+void CMDGrid::addChild(CMDBox *child, int zindex, uint32_t row, uint32_t col)
+{
+    if (row < rows.count && col < columns.count)
+    {
+        // add child to correct cell
+        auto cell = slot(row, col);
+        cell->addChild(child, zindex);
+
+        // adjust cell size to accommodate child (add a parameter that adjusts this)
+        if (sizeByContents)
+        {
+            // adjust row height based on maximum height in that row
+            // adjust column width based on maximum width in that column
+            for (uint32_t y = 0; y < rows.count; ++y)
+            {
+                for (uint32_t x = 0; x < columns.count; ++x)
+                {
+                    if (slot(y, x)->height > rows.rowheight[y])
+                        rows.rowheight[y] = slot(y, x)->height;
+                    if (slot(y, x)->width > columns.colwidth[x])
+                        columns.colwidth[x] = slot(y, x)->width;
+                }
+            }
+        }
+    }
+}
+
+void CMDGrid::setBordered(bool isBordered)
+{
+    // do nothing if status is same
+    if (bordered == isBordered) return;
+    
+    // otherwise, assume they are different
+    damage();
+
+    // borders move every cell, and change width and height accordingly
+    bordered = isBordered;
+    requestLayout(0, 0, false);
+
+    damage();
+}
+
+void CMDGrid::requestLayout(uint32_t row, uint32_t col, bool resized)
+{
+    pendingRow = std::min(pendingRow, row);
+    pendingCol = std::min(pendingCol, col);
+    pendingResize = pendingResize || resized;
+    CMDBox::requestLayout();
+}
+
+void CMDGrid::applyLayout()
+{
+    if (pendingRow != NO_CHANGE) layoutRows(std::min(pendingRow, rows.count));
+    if (pendingCol != NO_CHANGE) layoutColumns(std::min(pendingCol, columns.count));
+
+    // a change in size moves the grid around its anchor, and the cells with it
+    if (pendingResize) CMDBox::setPosition(boxPosition);
+    placeCells(pendingRow, pendingCol);
+
+    pendingRow = NO_CHANGE;
+    pendingCol = NO_CHANGE;
+    pendingResize = false;
+
+    // the cells are drawn as placed here until the next layout, and deleted ones no longer are
+    placed.resize((size_t)rows.count * columns.count);
+    for (uint32_t y = 0; y < rows.count; ++y)
+        std::copy(cells.begin() + (size_t)y * stride, cells.begin() + (size_t)y * stride + columns.count,
+                  placed.begin() + (size_t)y * columns.count);
+    placedColumns = columns.count;
+    placedBorder = bordered ? 1 : 0;
+    for (auto cell : retired) delete cell;
+    retired.clear();
+}
+
+void CMDGrid::layoutColumns(uint32_t from)
+{
+    uint32_t border = bordered ? 1 : 0;
+
+    // prefix sums of the column widths, with a border before each column
+    colStart.resize(columns.count + 1);
+    colStart[0] = border;
+    for (uint32_t i = from; i < columns.count; ++i)
+        colStart[i + 1] = colStart[i] + columns.colwidth[i] + border;
+
+    width = columns.count > 0 ? colStart[columns.count] : 0;
+    invalidateBounds();
+
+    // column under each x-offset, with -1 marking table borders
+    colAt.resize(width);
+    for (uint32_t i = from; i < columns.count; ++i)
+    {
+        if (bordered) colAt[colStart[i] - 1] = -1;
+        std::fill(colAt.begin() + colStart[i], colAt.begin() + colStart[i] + columns.colwidth[i], (int32_t)i);
+    }
+    if (bordered && width > 0) colAt[width - 1] = -1;
+}
+
+void CMDGrid::layoutRows(uint32_t from)
+{
+    uint32_t border = bordered ? 1 : 0;
+
+    // prefix sums of the row heights, with a border before each row
+    rowStart.resize(rows.count + 1);
+    rowStart[0] = border;
+    for (uint32_t i = from; i < rows.count; ++i)
+        rowStart[i + 1] = rowStart[i] + rows.rowheight[i] + border;
+
+    height = rows.count > 0 ? rowStart[rows.count] : 0;
+    invalidateBounds();
+
+    // row under each y-offset, with -1 marking table borders
+    rowAt.resize(height);
+    for (uint32_t i = from; i < rows.count; ++i)
+    {
+        if (bordered) rowAt[rowStart[i] - 1] = -1;
+        std::fill(rowAt.begin() + rowStart[i], rowAt.begin() + rowStart[i] + rows.rowheight[i], (int32_t)i);
+    }
+    if (bordered && height > 0) rowAt[height - 1] = -1;
+}
+
+void CMDGrid::placeCells(uint32_t fromRow, uint32_t fromCol)
+{
+    for (uint32_t y = 0; y < rows.count; ++y)
+    {
+        // only cells below fromRow or right of fromCol have moved
+        for (uint32_t x = (y >= fromRow ? 0 : fromCol); x < columns.count; ++x)
+        {
+            auto cell = slot(y, x);
+            int32_t nx = colStart[x];
+            int32_t ny = rowStart[y];
+            uint32_t nw = columns.colwidth[x];
+            uint32_t nh = rows.rowheight[y];
+
+            if (cell->offx != nx || cell->offy != ny)
+            {
+                // cells are placed relative to the grid, and their contents follow them
+                cell->offx = nx;
+                cell->offy = ny;
+                moved();
+            }
+            if (cell->width == nw && cell->height == nh) continue;
+
+            // contents are aligned within the cell again when its size changes
+            cell->setSize(nw, nh);
+            cell->forEachChild([](CMDBox *box) {box->setPosition(box->boxPosition);});
+        }
+    }
+}
+
+CMDFrame* CMDGrid::at(uint32_t x, uint32_t y)
+{
+    if (x < columns.count && y < rows.count)
+        return slot(y, x);
+    else return NULL;
+}
\ No newline at end of file
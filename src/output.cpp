@@ -0,0 +1,219 @@
+#include <algorithm>
+#include "../include/output.hpp"
+#include "../include/unicode.hpp"
+
+void OutputBuffer::writeNumber(uint32_t n)
+{
+    char digits[10];
+    int len = 0;
+    do {
+        digits[len++] = '0' + n % 10;
+        n /= 10;
+    } while (n > 0);
+
+    while (len > 0) data.push_back(digits[--len]);
+}
+
+// ways of moving the cursor, costed by the bytes they take
+typedef enum {
+    MOVE_NONE,
+    MOVE_ABSOLUTE,                      // CUP
+    MOVE_RELATIVE,                      // CUU/CUD, then CUF/CUB
+    MOVE_RETURN                         // CR, then LF or CUU/CUD, then CUF
+} CursorMove;
+
+static size_t digitCount(uint32_t n)
+{
+    size_t len = 1;
+    while (n >= 10)
+    {
+        n /= 10;
+        ++len;
+    }
+    return len;
+}
+
+size_t OutputBuffer::sequenceCost(uint32_t n)
+{
+    return n == 1 ? 3 : 3 + digitCount(n);
+}
+
+static size_t positionCost(uint32_t x, uint32_t y)
+{
+    return 3 + (y > 0 ? digitCount(y + 1) : 0) + (x > 0 ? 1 + digitCount(x + 1) : 0);
+}
+
+static CursorMove planMove(uint32_t fromx, uint32_t fromy, uint32_t tox, uint32_t toy, bool exact, bool feed, size_t &cost)
+{
+    cost = 0;
+    if (fromx == tox && fromy == toy) return MOVE_NONE;
+
+    CursorMove best = MOVE_ABSOLUTE;
+    cost = positionCost(tox, toy);
+
+    // relative moves need the column, unless they only go right along the row
+    uint32_t rows = (toy > fromy) ? toy - fromy : fromy - toy;
+    size_t vertical = (rows == 0) ? 0 : OutputBuffer::sequenceCost(rows);
+    if (exact || (toy == fromy && tox > fromx))
+    {
+        uint32_t columns = (tox > fromx) ? tox - fromx : fromx - tox;
+        size_t relative = vertical + (columns == 0 ? 0 : OutputBuffer::sequenceCost(columns));
+        if (relative < cost)
+        {
+            best = MOVE_RELATIVE;
+            cost = relative;
+        }
+    }
+
+    // a carriage return puts the column back at 0 wherever the cursor was held
+    size_t down = (toy > fromy && feed) ? std::min<size_t>(rows, vertical) : vertical;
+    size_t back = 1 + down + (tox > 0 ? OutputBuffer::sequenceCost(tox) : 0);
+    if (back < cost)
+    {
+        best = MOVE_RETURN;
+        cost = back;
+    }
+    return best;
+}
+
+void OutputBuffer::writeControl(uint32_t n, char final)
+{
+    data.push_back('\x1b');
+    data.push_back('[');
+    if (n != 1) writeNumber(n);
+    data.push_back(final);
+}
+
+void OutputBuffer::moveTo(uint32_t x, uint32_t y)
+{
+    // CSI row ; column H, both counted from 1 and left out when they are 1
+    data.push_back('\x1b');
+    data.push_back('[');
+    if (y > 0) writeNumber(y + 1);
+    if (x > 0)
+    {
+        data.push_back(';');
+        writeNumber(x + 1);
+    }
+    data.push_back('H');
+}
+
+void OutputBuffer::moveFrom(uint32_t fromx, uint32_t fromy, uint32_t tox, uint32_t toy, bool exact, bool feed)
+{
+    size_t cost;
+    switch (planMove(fromx, fromy, tox, toy, exact, feed, cost))
+    {
+        case MOVE_NONE:
+            break;
+
+        case MOVE_ABSOLUTE:
+            moveTo(tox, toy);
+            break;
+
+        case MOVE_RELATIVE:
+            if (toy > fromy) writeControl(toy - fromy, 'B');
+            if (toy < fromy) writeControl(fromy - toy, 'A');
+            if (tox > fromx) writeControl(tox - fromx, 'C');
+            if (tox < fromx) writeControl(fromx - tox, 'D');
+            break;
+
+        case MOVE_RETURN:
+            // line feeds also return the carriage on consoles translating them, which is harmless here
+            data.push_back('\r');
+            if (toy > fromy && feed && toy - fromy <= sequenceCost(toy - fromy)) data.insert(data.end(), toy - fromy, '\n');
+            else if (toy > fromy) writeControl(toy - fromy, 'B');
+            if (toy < fromy) writeControl(fromy - toy, 'A');
+            if (tox > 0) writeControl(tox, 'C');
+            break;
+    }
+}
+
+size_t OutputBuffer::moveCost(uint32_t fromx, uint32_t fromy, uint32_t tox, uint32_t toy, bool exact, bool feed)
+{
+    size_t cost;
+    planMove(fromx, fromy, tox, toy, exact, feed, cost);
+    return cost;
+}
+
+void OutputBuffer::write(const char *text, size_t len)
+{
+    data.insert(data.end(), text, text + len);
+}
+
+void OutputBuffer::writeGlyphs(const Cell *cells, size_t len)
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        uint32_t glyph = cellGlyph(cells[i]);
+        if (glyph < 0x80) data.push_back((char)glyph);
+        else if (glyph != WIDE_CONTINUATION)
+        {
+            // the right half of a wide character was covered by writing its left
+            char bytes[4];
+            data.insert(data.end(), bytes, bytes + encodeUtf8(glyph, bytes));
+        }
+    }
+}
+
+void OutputBuffer::setStyle(Style from, Style to)
+{
+    if (from == to) return;
+
+    // CSI parameters m, the defaults taking a single parameter
+    data.push_back('\x1b');
+    data.push_back('[');
+    if (to == 0)
+    {
+        data.push_back('0');
+        data.push_back('m');
+        return;
+    }
+
+    bool first = true;
+    auto param = [this, &first](uint32_t n) {
+        if (!first) data.push_back(';');
+        first = false;
+        writeNumber(n);
+    };
+
+    // attributes turned off, bold and dim going together
+    uint32_t was = styleAttributes(from), now = styleAttributes(to);
+    uint32_t off = was & ~now;
+    if (off & (ATTR_BOLD | ATTR_DIM))
+    {
+        param(22);
+        was &= ~(ATTR_BOLD | ATTR_DIM);
+    }
+    if (off & ATTR_ITALIC) param(23);
+    if (off & ATTR_UNDERLINE) param(24);
+    if (off & ATTR_BLINK) param(25);
+    if (off & ATTR_REVERSE) param(27);
+    if (off & ATTR_STRIKE) param(29);
+
+    // attributes turned on
+    uint32_t on = now & ~(was & ~off);
+    if (on & ATTR_BOLD) param(1);
+    if (on & ATTR_DIM) param(2);
+    if (on & ATTR_ITALIC) param(3);
+    if (on & ATTR_UNDERLINE) param(4);
+    if (on & ATTR_BLINK) param(5);
+    if (on & ATTR_REVERSE) param(7);
+    if (on & ATTR_STRIKE) param(9);
+
+    // named colors have their own parameter, the rest of the palette takes three
+    auto color = [&param](uint32_t c, uint32_t base) {
+        if (c == COLOR_DEFAULT) param(base + 9);
+        else if (c <= COLOR_WHITE) param(base + c - COLOR_BLACK);
+        else if (c <= COLOR_BRIGHT_WHITE) param(base + 60 + c - COLOR_BRIGHT_BLACK);
+        else
+        {
+            param(base + 8);
+            param(5);
+            param(c - 1);
+        }
+    };
+    if (styleForeground(from) != styleForeground(to)) color(styleForeground(to), 30);
+    if (styleBackground(from) != styleBackground(to)) color(styleBackground(to), 40);
+
+    data.push_back('m');
+}
@@ -0,0 +1,24 @@
+#include "../include/pool.hpp"
+
+NodePool* NodePool::create()
+{
+    return new NodePool();
+}
+
+void NodePool::release()
+{
+    if (--refs == 0) delete this;
+}
+
+void* NodePool::do_allocate(size_t bytes, size_t alignment)
+{
+    void *p = blocks.allocate(bytes, alignment);
+    ++refs;
+    return p;
+}
+
+void NodePool::do_deallocate(void *p, size_t bytes, size_t alignment)
+{
+    blocks.deallocate(p, bytes, alignment);
+    if (--refs == 0) delete this;
+}
@@ -0,0 +1,229 @@
+#include <cstring>
+#include <algorithm>
+#include "../include/raster.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RASTER_X86 1
+#endif
+
+typedef struct RasterKernels {
+    const char *name;
+    void (*fill)(Cell *dst, Cell cell, size_t len);
+    void (*blit)(Cell *dst, const Cell *src, size_t len);
+    void (*text)(Cell *dst, const char *text, size_t len, Style style);
+    void (*glyphs)(Cell *dst, const uint32_t *glyphs, size_t len, Style style);
+} RasterKernels;
+
+static void fillScalar(Cell *dst, Cell cell, size_t len)
+{
+    std::fill_n(dst, len, cell);
+}
+
+static void blitScalar(Cell *dst, const Cell *src, size_t len)
+{
+    std::memmove(dst, src, len * sizeof(Cell));
+}
+
+static void textScalar(Cell *dst, const char *text, size_t len, Style style)
+{
+    for (size_t i = 0; i < len; ++i)
+        if (text[i] != 0) dst[i] = makeCell((unsigned char)text[i], style);
+}
+
+static void glyphsScalar(Cell *dst, const uint32_t *glyphs, size_t len, Style style)
+{
+    for (size_t i = 0; i < len; ++i)
+        if (glyphs[i] != 0) dst[i] = makeCell(glyphs[i], style);
+}
+
+#ifdef RASTER_X86
+
+__attribute__((target("sse2")))
+static void fillSSE2(Cell *dst, Cell cell, size_t len)
+{
+    __m128i v = _mm_set1_epi64x(cell);
+    size_t i = 0;
+    for (; i + 2 <= len; i += 2) _mm_storeu_si128((__m128i*)(dst + i), v);
+    if (i < len) dst[i] = cell;
+}
+
+__attribute__((target("sse2")))
+static void blitSSE2(Cell *dst, const Cell *src, size_t len)
+{
+    // overlapping runs are rare, and left to memmove
+    if (dst < src + len && src < dst + len) return blitScalar(dst, src, len);
+
+    size_t i = 0;
+    for (; i + 2 <= len; i += 2)
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_loadu_si128((const __m128i*)(src + i)));
+    if (i < len) dst[i] = src[i];
+}
+
+// holes are the zero glyphs; the mask of each is spread over its whole cell, keeping the cell below
+__attribute__((target("sse2")))
+static inline __m128i blendCellsSSE2(__m128i glyphs, __m128i cells, __m128i below)
+{
+    __m128i hole = _mm_cmpeq_epi32(glyphs, _mm_setzero_si128());
+    hole = _mm_shuffle_epi32(hole, _MM_SHUFFLE(2, 2, 0, 0));
+    return _mm_or_si128(_mm_and_si128(hole, below), _mm_andnot_si128(hole, cells));
+}
+
+__attribute__((target("sse2")))
+static void textSSE2(Cell *dst, const char *text, size_t len, Style style)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i styled = _mm_set1_epi64x(makeCell(0, style));
+    size_t i = 0;
+    for (; i + 2 <= len; i += 2)
+    {
+        // two characters widened to the low half of a cell each
+        __m128i g = _mm_cvtsi32_si128((unsigned char)text[i] | (unsigned char)text[i + 1] << 16);
+        g = _mm_unpacklo_epi32(_mm_unpacklo_epi16(g, zero), zero);
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), blendCellsSSE2(g, _mm_or_si128(g, styled), d));
+    }
+    textScalar(dst + i, text + i, len - i, style);
+}
+
+__attribute__((target("sse2")))
+static void glyphsSSE2(Cell *dst, const uint32_t *glyphs, size_t len, Style style)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i styled = _mm_set1_epi64x(makeCell(0, style));
+    size_t i = 0;
+    for (; i + 2 <= len; i += 2)
+    {
+        __m128i g = _mm_unpacklo_epi32(_mm_loadl_epi64((const __m128i*)(glyphs + i)), zero);
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), blendCellsSSE2(g, _mm_or_si128(g, styled), d));
+    }
+    glyphsScalar(dst + i, glyphs + i, len - i, style);
+}
+
+__attribute__((target("avx2")))
+static void fillAVX2(Cell *dst, Cell cell, size_t len)
+{
+    __m256i v = _mm256_set1_epi64x(cell);
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) _mm256_storeu_si256((__m256i*)(dst + i), v);
+    for (; i < len; ++i) dst[i] = cell;
+}
+
+__attribute__((target("avx2")))
+static void blitAVX2(Cell *dst, const Cell *src, size_t len)
+{
+    if (dst < src + len && src < dst + len) return blitScalar(dst, src, len);
+
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4)
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_loadu_si256((const __m256i*)(src + i)));
+    for (; i < len; ++i) dst[i] = src[i];
+}
+
+__attribute__((target("avx2")))
+static void textAVX2(Cell *dst, const char *text, size_t len, Style style)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i styled = _mm256_set1_epi64x(makeCell(0, style));
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4)
+    {
+        int32_t four;
+        std::memcpy(&four, text + i, sizeof(four));
+        __m256i g = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(four));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i hole = _mm256_cmpeq_epi64(g, zero);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(_mm256_or_si256(g, styled), d, hole));
+    }
+    textScalar(dst + i, text + i, len - i, style);
+}
+
+__attribute__((target("avx2")))
+static void glyphsAVX2(Cell *dst, const uint32_t *glyphs, size_t len, Style style)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i styled = _mm256_set1_epi64x(makeCell(0, style));
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4)
+    {
+        __m256i g = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(glyphs + i)));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i hole = _mm256_cmpeq_epi64(g, zero);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_blendv_epi8(_mm256_or_si256(g, styled), d, hole));
+    }
+    glyphsScalar(dst + i, glyphs + i, len - i, style);
+}
+
+#endif
+
+static const RasterKernels scalarKernels = {"scalar", fillScalar, blitScalar, textScalar, glyphsScalar};
+#ifdef RASTER_X86
+static const RasterKernels sse2Kernels = {"sse2", fillSSE2, blitSSE2, textSSE2, glyphsSSE2};
+static const RasterKernels avx2Kernels = {"avx2", fillAVX2, blitAVX2, textAVX2, glyphsAVX2};
+#endif
+
+static const RasterKernels* findKernels(std::string_view name)
+{
+#ifdef RASTER_X86
+    __builtin_cpu_init();
+    if (name == "avx2" && __builtin_cpu_supports("avx2")) return &avx2Kernels;
+    if (name == "sse2" && __builtin_cpu_supports("sse2")) return &sse2Kernels;
+#endif
+    if (name == "scalar") return &scalarKernels;
+    return NULL;
+}
+
+static const RasterKernels*& activeKernels()
+{
+    // the best set the processor supports, picked on first use
+    static const RasterKernels *active = [] {
+        for (auto name : {"avx2", "sse2"})
+        {
+            auto found = findKernels(name);
+            if (found != NULL) return found;
+        }
+        return &scalarKernels;
+    }();
+    return active;
+}
+
+// runs shorter than this are not worth the indirect call
+static const size_t MIN_KERNEL_RUN = 8;
+
+void fillRow(Cell *dst, Cell cell, size_t len)
+{
+    if (len < MIN_KERNEL_RUN) { for (size_t i = 0; i < len; ++i) dst[i] = cell; return; }
+    activeKernels()->fill(dst, cell, len);
+}
+
+void blitRow(Cell *dst, const Cell *src, size_t len)
+{
+    if (len < MIN_KERNEL_RUN) { std::memmove(dst, src, len * sizeof(Cell)); return; }
+    activeKernels()->blit(dst, src, len);
+}
+
+void compositeText(Cell *dst, const char *text, size_t len, Style style)
+{
+    if (len < MIN_KERNEL_RUN) { textScalar(dst, text, len, style); return; }
+    activeKernels()->text(dst, text, len, style);
+}
+
+void compositeText(Cell *dst, const uint32_t *glyphs, size_t len, Style style)
+{
+    if (len < MIN_KERNEL_RUN) { glyphsScalar(dst, glyphs, len, style); return; }
+    activeKernels()->glyphs(dst, glyphs, len, style);
+}
+
+std::string_view rasterKernels()
+{
+    return activeKernels()->name;
+}
+
+bool useRasterKernels(std::string_view name)
+{
+    auto found = findKernels(name);
+    if (found == NULL) return false;
+    activeKernels() = found;
+    return true;
+}
@@ -0,0 +1,219 @@
+#include <cstdio>
+#include <cerrno>
+#include <algorithm>
+#include "../include/sink.hpp"
+#include "../include/unicode.hpp"
+
+// ways of sending a stretch of the same cell
+typedef enum {
+    CODE_WRITE,                         // as it is
+    CODE_REPEAT,                        // the cell once, then REP
+    CODE_ERASE,                         // ECH, then a move past the stretch unless it ends the run
+    CODE_ERASE_LINE                     // EL, for a stretch reaching the edge of the console
+} Coding;
+
+void FdSink::seek(uint32_t x, uint32_t y, bool feed)
+{
+    if (cursorKnown) output.moveFrom(cursorx, cursory, x, y, cursorExact, feed);
+    else output.moveTo(x, y);
+
+    cursorx = x;
+    cursory = y;
+    cursorKnown = true;
+    cursorExact = true;
+}
+
+void FdSink::writeRun(uint32_t x, uint32_t y, const Cell *cells, size_t len)
+{
+    // the row of a run is on the screen, so line feeds cannot scroll it
+    seek(x, y, true);
+    cursorx = x + len;
+    cursorExact = false;
+
+    // one SGR sequence per change of style, carried over from the previous run
+    for (size_t i = 0; i < len; )
+    {
+        Style style = cellStyle(cells[i]);
+        size_t end = i + 1;
+        while (end < len && cellStyle(cells[end]) == style) ++end;
+
+        output.setStyle(current, style);
+        current = style;
+        if (capabilities == 0) output.writeGlyphs(cells + i, end - i);
+        else writeStretches(x + i, y, cells + i, end - i, end == len);
+        i = end;
+    }
+}
+
+void FdSink::writeStretches(uint32_t x, uint32_t y, const Cell *cells, size_t len, bool last)
+{
+    size_t plain = 0;                   // first cell not queued yet
+    for (size_t i = 0; i < len; )
+    {
+        size_t end = i + 1;
+        while (end < len && cells[end] == cells[i]) ++end;
+        size_t count = end - i;
+
+        // the right halves of wide characters take no bytes, and are never repeated
+        uint32_t glyph = cellGlyph(cells[i]);
+        size_t bytes = (glyph == WIDE_CONTINUATION) ? 0 : utf8Length(glyph);
+        size_t best = count * bytes;
+        Coding how = CODE_WRITE;
+        if ((capabilities & CAP_REPEAT) && count > 1 && bytes + OutputBuffer::sequenceCost(count - 1) < best)
+        {
+            best = bytes + OutputBuffer::sequenceCost(count - 1);
+            how = CODE_REPEAT;
+        }
+        // erased cells take the background of the current style, so only default blanks are erased
+        if ((capabilities & CAP_ERASE) && cells[i] == makeCell(' '))
+        {
+            bool tail = last && end == len;
+            size_t erase = OutputBuffer::sequenceCost(count);
+            if (!tail) erase += OutputBuffer::moveCost(x + i, y, x + end, y, true, true);
+            if (erase < best)
+            {
+                best = erase;
+                how = CODE_ERASE;
+            }
+            if (tail && columns != 0 && x + end == columns && 3 < best) how = CODE_ERASE_LINE;
+        }
+
+        if (how != CODE_WRITE)
+        {
+            output.writeGlyphs(cells + plain, i - plain);
+            plain = end;
+        }
+
+        switch (how)
+        {
+            case CODE_WRITE:
+                break;
+
+            case CODE_REPEAT:
+                output.writeGlyphs(cells + i, 1);
+                output.repeat(count - 1);
+                break;
+
+            case CODE_ERASE:
+            case CODE_ERASE_LINE:
+                if (how == CODE_ERASE) output.eraseChars(count);
+                else output.eraseLine();
+
+                // the cursor stays put, and is left there at the end of the run
+                if (end < len || !last) output.moveFrom(x + i, y, x + end, y, true, true);
+                else
+                {
+                    cursorx = x + i;
+                    cursorExact = true;
+                }
+                break;
+        }
+        i = end;
+    }
+    output.writeGlyphs(cells + plain, len - plain);
+}
+
+void FdSink::resetStyle()
+{
+    output.setStyle(current, 0);
+    current = 0;
+}
+
+void FdSink::moveCursor(uint32_t x, uint32_t y)
+{
+    seek(x, y, false);
+}
+
+size_t FdSink::moveCost(uint32_t fromx, uint32_t tox, uint32_t y) const
+{
+    return OutputBuffer::moveCost(fromx, y, tox, y, false, true);
+}
+
+size_t FdSink::flush()
+{
+    // whatever is printed after the frame gets the default style, and may move the cursor
+    resetStyle();
+    cursorKnown = false;
+    if (output.size() == 0) return 0;
+
+    // anything printed before must reach the console first
+    if (fd == STDOUT_FILENO) fflush(stdout);
+
+    size_t done = 0;
+    while (done < output.size())
+    {
+        ssize_t n = ::write(fd, output.bytes() + done, output.size() - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += n;
+    }
+
+    output.clear();
+    return done;
+}
+
+MemorySink::MemorySink(uint32_t wid, uint32_t hig) : width(wid), height(hig), cells((size_t)wid * hig, makeCell(' '))
+{
+}
+
+void MemorySink::reserve(uint32_t wid, uint32_t hig)
+{
+    if (wid <= width && hig <= height) return;
+
+    // rows are copied over to the wider screen
+    uint32_t newWidth = std::max(width, wid);
+    uint32_t newHeight = std::max(height, hig);
+    std::vector<Cell> grown((size_t)newWidth * newHeight, makeCell(' '));
+    for (uint32_t y = 0; y < height; ++y)
+        std::copy_n(cells.data() + (size_t)y * width, width, grown.data() + (size_t)y * newWidth);
+
+    cells.swap(grown);
+    width = newWidth;
+    height = newHeight;
+}
+
+void MemorySink::writeRun(uint32_t x, uint32_t y, const Cell *run, size_t len)
+{
+    reserve(x + len, y + 1);
+    std::copy_n(run, len, cells.data() + (size_t)y * width + x);
+    cursorx = x + len;
+    cursory = y;
+    written += len;
+}
+
+size_t MemorySink::flush()
+{
+    size_t count = written;
+    written = 0;
+    return count;
+}
+
+Cell MemorySink::cellAt(uint32_t x, uint32_t y) const
+{
+    if (x >= width || y >= height) return makeCell(' ');
+    return cells[(size_t)y * width + x];
+}
+
+std::string MemorySink::toString() const
+{
+    std::string text;
+    text.reserve((size_t)(width + 1) * height);
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        if (y > 0) text.push_back('\n');
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            uint32_t glyph = cellGlyph(cells[(size_t)y * width + x]);
+            if (glyph == WIDE_CONTINUATION) continue;
+
+            char bytes[4];
+            text.append(bytes, encodeUtf8(glyph, bytes));
+        }
+    }
+    return text;
+}
+
+void MemorySink::clear()
+{
+    std::fill(cells.begin(), cells.end(), makeCell(' '));
+}
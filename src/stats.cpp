@@ -0,0 +1,73 @@
+#include <atomic>
+#include <chrono>
+#include "../include/stats.hpp"
+
+uint64_t statClock()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t statThread()
+{
+    static std::atomic<uint32_t> threads{0};
+    thread_local uint32_t number = ++threads;
+    return number;
+}
+
+TraceFile::~TraceFile()
+{
+    close();
+}
+
+bool TraceFile::open(const std::string &path)
+{
+    close();
+    file = fopen(path.c_str(), "w");
+    if (file == NULL) return false;
+
+    fputs("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [", file);
+    empty = true;
+    return true;
+}
+
+void TraceFile::close()
+{
+    if (file == NULL) return;
+    fputs("\n]}\n", file);
+    fclose(file);
+    file = NULL;
+}
+
+void TraceFile::startEvent()
+{
+    fputs(empty ? "\n" : ",\n", file);
+    empty = false;
+}
+
+void TraceFile::span(const char *name, TraceSpan span, const FrameStats *stats)
+{
+    if (file == NULL) return;
+
+    // timestamps are in microseconds
+    startEvent();
+    fprintf(file, "{\"name\": \"%s\", \"cat\": \"render\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f",
+            name, span.thread, span.start / 1e3, span.duration / 1e3);
+    if (stats != NULL)
+    {
+        fprintf(file, ", \"args\": {\"frame\": %llu, \"spansPainted\": %llu, \"boxesVisited\": %llu, \"cellsChanged\": %llu, \"bytesWritten\": %llu}",
+                (unsigned long long)stats->frame, (unsigned long long)stats->spansPainted, (unsigned long long)stats->boxesVisited,
+                (unsigned long long)stats->cellsChanged, (unsigned long long)stats->bytesWritten);
+    }
+    fputc('}', file);
+}
+
+void TraceFile::counters(uint64_t time, const FrameStats &stats)
+{
+    if (file == NULL) return;
+
+    startEvent();
+    fprintf(file, "{\"name\": \"frame counters\", \"cat\": \"render\", \"ph\": \"C\", \"pid\": 1, \"ts\": %.3f, "
+            "\"args\": {\"boxesVisited\": %llu, \"cellsChanged\": %llu, \"bytesWritten\": %llu}}",
+            time / 1e3, (unsigned long long)stats.boxesVisited, (unsigned long long)stats.cellsChanged,
+            (unsigned long long)stats.bytesWritten);
+}
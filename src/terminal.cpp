@@ -0,0 +1,188 @@
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include "../include/terminal.hpp"
+
+// DEC private modes set while the terminal is open
+static const char *ENTER_SCREEN = "\x1b[?1049h\x1b[?25l";             // alternate screen, hidden cursor
+static const char *CLEAR_SCREEN = "\x1b[2J";
+static const char LEAVE_SCREEN[] = "\x1b[?25h\x1b[?1049l";
+static const char *BEGIN_SYNC = "\x1b[?2026h";
+static const char *END_SYNC = "\x1b[?2026l";
+
+// a blank written and repeated once from the corner, then a cursor position report
+static const char *PROBE_REPEAT = "\x1b[H \x1b[b\x1b[6n";
+static const int PROBE_TIMEOUT_MS = 200;
+
+// signals that end the process by default, leaving the terminal as the sink set it
+static const int RESTORED_SIGNALS[] = {SIGINT, SIGTERM, SIGHUP, SIGQUIT};
+static const int SIGNAL_COUNT = sizeof(RESTORED_SIGNALS) / sizeof(RESTORED_SIGNALS[0]);
+
+// the sink whose terminal is restored on those signals, with what the handler needs of it
+static TerminalSink *signalOwner = NULL;
+static int signalFd = -1;
+static struct termios signalModes;
+static struct sigaction previousActions[SIGNAL_COUNT];
+static bool installed[SIGNAL_COUNT];
+
+static void restoreOnSignal(int sig)
+{
+    // only async-signal-safe calls, then the signal is delivered again as it would have been
+    ssize_t written = write(signalFd, LEAVE_SCREEN, sizeof(LEAVE_SCREEN) - 1);
+    (void)written;
+    tcsetattr(signalFd, TCSANOW, &signalModes);
+    for (int i = 0; i < SIGNAL_COUNT; ++i)
+        if (RESTORED_SIGNALS[i] == sig) sigaction(sig, &previousActions[i], NULL);
+    raise(sig);
+}
+
+void TerminalSink::watchSignals()
+{
+    if (signalOwner != NULL) return;
+    signalOwner = this;
+    signalFd = fd;
+    signalModes = saved;
+
+    // signals the application handles or ignores itself are left to it
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = restoreOnSignal;
+    sigemptyset(&action.sa_mask);
+    for (int i = 0; i < SIGNAL_COUNT; ++i)
+    {
+        installed[i] = false;
+        if (sigaction(RESTORED_SIGNALS[i], NULL, &previousActions[i]) != 0) continue;
+        if (previousActions[i].sa_handler != SIG_DFL) continue;
+        installed[i] = sigaction(RESTORED_SIGNALS[i], &action, NULL) == 0;
+    }
+}
+
+void TerminalSink::unwatchSignals()
+{
+    if (signalOwner != this) return;
+    for (int i = 0; i < SIGNAL_COUNT; ++i)
+        if (installed[i]) sigaction(RESTORED_SIGNALS[i], &previousActions[i], NULL);
+    signalOwner = NULL;
+}
+
+TerminalSink::~TerminalSink()
+{
+    close();
+}
+
+void TerminalSink::control(const char *seq)
+{
+    output.write(seq, strlen(seq));
+}
+
+bool TerminalSink::open()
+{
+    if (opened) return true;
+    if (tcgetattr(fd, &saved) != 0) return false;
+
+    // keys pressed while drawing must not be echoed over the frame
+    struct termios modes = saved;
+    modes.c_lflag &= ~(ICANON | ECHO);
+    modes.c_cc[VMIN] = 1;
+    modes.c_cc[VTIME] = 0;
+    if (tcsetattr(fd, TCSAFLUSH, &modes) != 0) return false;
+
+    opened = true;
+    watchSignals();
+    control(ENTER_SCREEN);
+    capabilities = CAP_ERASE | (probeRepeat() ? CAP_REPEAT : 0);
+    control(CLEAR_SCREEN);
+    FdSink::flush();
+    return true;
+}
+
+void TerminalSink::close()
+{
+    if (!opened) return;
+
+    unwatchSignals();
+
+    // a frame left half written is dropped, rather than shown on the main screen
+    output.clear();
+    syncing = false;
+    started = false;
+    current = 0;
+    control(LEAVE_SCREEN);
+    FdSink::flush();
+    tcsetattr(fd, TCSAFLUSH, &saved);
+    opened = false;
+}
+
+bool TerminalSink::probeRepeat()
+{
+    control(PROBE_REPEAT);
+    FdSink::flush();
+
+    // the report is read a byte at a time, leaving any keys pressed after it
+    char reply[32];
+    size_t len = 0;
+    while (len < sizeof(reply) - 1)
+    {
+        struct pollfd ready = {fd, POLLIN, 0};
+        if (poll(&ready, 1, PROBE_TIMEOUT_MS) <= 0) return false;
+
+        ssize_t n = ::read(fd, reply + len, 1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        if (reply[len++] == 'R') break;
+    }
+    reply[len] = 0;
+
+    // CSI row ; column R, the column being 3 if both blanks were written
+    const char *report = strrchr(reply, '\x1b');
+    unsigned row, column;
+    return report != NULL && sscanf(report, "\x1b[%u;%uR", &row, &column) == 2 && column == 3;
+}
+
+bool TerminalSink::getSize(uint32_t &wid, uint32_t &hig) const
+{
+    struct winsize size;
+    if (ioctl(fd, TIOCGWINSZ, &size) != 0 || size.ws_col == 0 || size.ws_row == 0) return false;
+    wid = size.ws_col;
+    hig = size.ws_row;
+    return true;
+}
+
+void TerminalSink::startFrame()
+{
+    if (started) return;
+    started = true;
+
+    // the terminal may have been resized since the last frame
+    uint32_t wid, hig;
+    columns = getSize(wid, hig) ? wid : 0;
+
+    if (!synchronized) return;
+    control(BEGIN_SYNC);
+    syncing = true;
+}
+
+void TerminalSink::writeRun(uint32_t x, uint32_t y, const Cell *cells, size_t len)
+{
+    startFrame();
+    FdSink::writeRun(x, y, cells, len);
+}
+
+void TerminalSink::moveCursor(uint32_t x, uint32_t y)
+{
+    startFrame();
+    FdSink::moveCursor(x, y);
+}
+
+size_t TerminalSink::flush()
+{
+    // the terminal shows the frame once the update ends, in the default style
+    resetStyle();
+    if (syncing) control(END_SYNC);
+    syncing = false;
+    started = false;
+    return FdSink::flush();
+}
@@ -0,0 +1,69 @@
+#include "../include/threadpool.hpp"
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    // the caller of run is one of the threads
+    for (unsigned i = 1; i < threads; ++i) workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers) worker.join();
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)> &task)
+{
+    if (count == 0) return;
+
+    // small jobs are not worth waking anyone
+    if (workers.empty() || count == 1)
+    {
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        job = &task;
+        jobSize = count;
+        next = 0;
+        busy = workers.size();
+        ++posted;
+    }
+    wake.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [this] {return busy == 0;});
+    job = NULL;
+}
+
+void ThreadPool::drain()
+{
+    for (size_t i = next++; i < jobSize; i = next++) (*job)(i);
+}
+
+void ThreadPool::work()
+{
+    uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&] {return stopping || posted != seen;});
+            if (stopping) return;
+            seen = posted;
+        }
+
+        drain();
+
+        std::lock_guard<std::mutex> guard(lock);
+        if (--busy == 0) done.notify_one();
+    }
+}
@@ -0,0 +1,99 @@
+#include "../include/unicode.hpp"
+
+// generated in widths.cpp: a block per 256 code points, then 2 bits of width per code point
+extern const uint8_t WIDTH_BLOCKS[];
+extern const uint8_t WIDTH_CELLS[][64];
+
+static const uint32_t CODE_POINT_LIMIT = 0x110000;
+
+uint32_t glyphWidth(uint32_t cp)
+{
+    if (cp >= CODE_POINT_LIMIT) return 1;
+    const uint8_t *block = WIDTH_CELLS[WIDTH_BLOCKS[cp >> 8]];
+    return (block[(cp & 0xff) >> 2] >> ((cp & 3) * 2)) & 3;
+}
+
+uint32_t decodeUtf8(std::string_view text, size_t &pos)
+{
+    unsigned char lead = text[pos++];
+    if (lead < 0x80) return lead;
+
+    // the lead byte gives the length, and the bits it contributes
+    size_t extra;
+    uint32_t cp, least;
+    if ((lead & 0xe0) == 0xc0) { extra = 1; cp = lead & 0x1f; least = 0x80; }
+    else if ((lead & 0xf0) == 0xe0) { extra = 2; cp = lead & 0x0f; least = 0x800; }
+    else if ((lead & 0xf8) == 0xf0) { extra = 3; cp = lead & 0x07; least = 0x10000; }
+    else return REPLACEMENT_CHARACTER;
+
+    for (size_t i = 0; i < extra; ++i)
+    {
+        // a truncated sequence is replaced, and decoding resumes at the byte that cut it short
+        if (pos >= text.size() || ((unsigned char)text[pos] & 0xc0) != 0x80) return REPLACEMENT_CHARACTER;
+        cp = (cp << 6) | ((unsigned char)text[pos++] & 0x3f);
+    }
+
+    // overlong forms, surrogates and code points past the last plane are all malformed
+    if (cp < least || (cp >= 0xd800 && cp <= 0xdfff) || cp >= CODE_POINT_LIMIT) return REPLACEMENT_CHARACTER;
+    return cp;
+}
+
+size_t encodeUtf8(uint32_t cp, char *out)
+{
+    if (cp < 0x80)
+    {
+        out[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800)
+    {
+        out[0] = (char)(0xc0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3f));
+        return 2;
+    }
+    if (cp < 0x10000)
+    {
+        out[0] = (char)(0xe0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3f));
+        out[2] = (char)(0x80 | (cp & 0x3f));
+        return 3;
+    }
+    out[0] = (char)(0xf0 | (cp >> 18));
+    out[1] = (char)(0x80 | ((cp >> 12) & 0x3f));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3f));
+    out[3] = (char)(0x80 | (cp & 0x3f));
+    return 4;
+}
+
+bool isPlainText(std::string_view text)
+{
+    for (char c : text)
+        if (c < 0x20 || c > 0x7e) return false;
+    return true;
+}
+
+uint32_t textWidth(std::string_view text)
+{
+    if (isPlainText(text)) return text.size();
+
+    uint32_t columns = 0;
+    for (size_t pos = 0; pos < text.size(); ) columns += glyphWidth(decodeUtf8(text, pos));
+    return columns;
+}
+
+void layoutText(std::string_view text, std::vector<uint32_t> &glyphs)
+{
+    glyphs.clear();
+    for (size_t pos = 0; pos < text.size(); )
+    {
+        uint32_t cp = decodeUtf8(text, pos);
+        uint32_t columns = glyphWidth(cp);
+
+        // newlines are kept for the lines to be broken at
+        if (cp == '\n') glyphs.push_back(cp);
+        if (columns == 0) continue;
+
+        glyphs.push_back(cp);
+        if (columns == 2) glyphs.push_back(WIDE_CONTINUATION);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+#pragma once
+
+#include <cstdio>
+
+// checks that failed so far; a test passes if none did
+inline int checkFailures = 0;
+
+// report a failed condition with where it was checked, and carry on
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) \
+        { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++checkFailures; \
+        } \
+    } while (0)
+
+/**
+ * @brief End a test, reporting how many checks failed
+ *
+ * @return int exit status, 0 if every check passed
+ */
+inline int checkResult()
+{
+    if (checkFailures == 0) return 0;
+    std::fprintf(stderr, "%d checks failed\n", checkFailures);
+    return 1;
+}
+
+#endif
@@ -0,0 +1,178 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <thread>
+#include "../include/frame.hpp"
+#include "../include/threadpool.hpp"
+#include "check.hpp"
+
+// a tree painted in bands on a thread pool writes the same bytes, frame after frame, as one painted serially
+
+// one of two identical trees, changed the same way
+typedef struct Scene {
+    CMDFrame root;
+    FILE *file;
+    FdSink sink;
+    std::vector<CMDBox*> boxes;
+    std::mt19937 rng;
+
+    Scene(uint32_t wid, uint32_t hig, unsigned seed) : root("root", wid, hig), file(std::tmpfile()), sink(fileno(file)), rng(seed)
+    {
+        sink.setCapabilities(CAP_REPEAT | CAP_ERASE);
+        root.setSink(&sink);
+    }
+    ~Scene() {std::fclose(file);}
+
+    uint32_t pick(uint32_t n) {return rng() % n;}
+} Scene;
+
+static void build(Scene &scene, CMDFrame *frame, int depth)
+{
+    // long enough that wrapping it takes a while, so bands breaking it at once overlap
+    std::string words;
+    for (int i = 0; i < 200; ++i) words += "some words to wrap ";
+
+    for (uint32_t count = 3 + scene.pick(6); count > 0; --count)
+    {
+        std::unique_ptr<CMDBox> made;
+        if (depth < 2 && scene.pick(3) == 0) made = std::make_unique<CMDFrame>("f", 4 + scene.pick(30), 4 + scene.pick(20));
+        else made = std::make_unique<CMDBox>("b", words, 1 + scene.pick(20), 1 + scene.pick(12));
+        auto box = frame->addChild(std::move(made), scene.pick(4));
+        box->setBordered(scene.pick(2));
+        box->setStyle(makeStyle(scene.pick(17), scene.pick(17)));
+        box->setPosition(scene.pick(frame->width), scene.pick(frame->height), true);
+        scene.boxes.push_back(box);
+        if (auto child = dynamic_cast<CMDFrame*>(box)) build(scene, child, depth + 1);
+    }
+}
+
+static void mutate(Scene &scene)
+{
+    auto box = scene.boxes[scene.pick(scene.boxes.size())];
+    switch (scene.pick(7))
+    {
+        case 0: box->setPosition((TextPosition)scene.pick(9)); break;
+        case 1: box->setText(std::string(scene.pick(40), "ab "[scene.pick(3)])); break;
+        case 2: box->setSize(1 + scene.pick(20), 1 + scene.pick(12)); break;
+        case 3: box->setBordered(scene.pick(2)); break;
+        case 4: box->setZIndex(scene.pick(4)); break;
+        case 5:
+            box->isVisible = !box->isVisible;
+            box->damage();
+            break;
+
+        case 6:
+            // fields written directly leave the caches to be refreshed lazily
+            box->width = 1 + scene.pick(20);
+            scene.root.damage();
+            break;
+    }
+}
+
+// everything written to the file of a scene since the last call
+static std::string drain(Scene &scene)
+{
+    std::fflush(scene.file);
+    std::rewind(scene.file);
+    std::string bytes;
+    char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), scene.file)) > 0) bytes.append(buf, n);
+    std::rewind(scene.file);
+    if (ftruncate(fileno(scene.file), 0) != 0) bytes.clear();
+    return bytes;
+}
+
+static void randomScenes(ThreadPool &pool)
+{
+    for (unsigned seed = 0; seed < 40; ++seed)
+    {
+        Scene serial(80, 40, seed), banded(80, 40, seed);
+        banded.root.setRenderPool(&pool);
+        build(serial, &serial.root, 0);
+        build(banded, &banded.root, 0);
+
+        for (int frame = 0; frame < 30; ++frame)
+        {
+            if (frame % 2 == 0)
+            {
+                serial.root.display();
+                banded.root.display();
+            }
+            else
+            {
+                serial.root.flush();
+                banded.root.flush();
+            }
+            CHECK(drain(serial) == drain(banded));
+
+            for (uint32_t changes = 1 + serial.pick(2); changes > 0; --changes)
+            {
+                banded.rng = serial.rng;
+                mutate(serial);
+                mutate(banded);
+            }
+        }
+    }
+}
+
+// a tall box of wrapped text resized between frames is wrapped once, before the bands read it
+static void tallWrappedBox(ThreadPool &pool)
+{
+    std::string text;
+    for (int i = 0; i < 400; ++i) text += "wrapped words ";
+
+    Scene serial(80, 40, 0), banded(80, 40, 0);
+    banded.root.setRenderPool(&pool);
+    for (Scene *scene : {&serial, &banded})
+    {
+        scene->boxes.push_back(scene->root.addChild(std::make_unique<CMDBox>("tall", text, 30, 38), 0));
+    }
+    serial.root.display();
+    banded.root.display();
+    drain(serial);
+    drain(banded);
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        for (Scene *scene : {&serial, &banded})
+        {
+            if (i % 2) scene->boxes[0]->setWidth(10 + i % 50);
+            else scene->boxes[0]->width = 10 + i % 50;
+            scene->root.display();
+        }
+        CHECK(drain(serial) == drain(banded));
+    }
+}
+
+// two trees driven from their own threads share nothing, and write what either does alone
+static void separateTrees()
+{
+    std::string bytes[2];
+    auto drive = [&bytes](int which) {
+        Scene scene(80, 40, 7);
+        build(scene, &scene.root, 0);
+        for (int frame = 0; frame < 30; ++frame)
+        {
+            scene.root.display();
+            bytes[which] += drain(scene);
+            mutate(scene);
+        }
+    };
+
+    std::thread first(drive, 0), second(drive, 1);
+    first.join();
+    second.join();
+    CHECK(!bytes[0].empty());
+    CHECK(bytes[0] == bytes[1]);
+}
+
+int main()
+{
+    ThreadPool pool(4);
+    randomScenes(pool);
+    tallWrappedBox(pool);
+    separateTrees();
+    return checkResult();
+}
@@ -0,0 +1,252 @@
+#include <random>
+#include <vector>
+#include "../include/frame.hpp"
+#include "check.hpp"
+
+// flushing the damaged areas of a tree changed through its mutators leaves the screen cell for cell as getCellIn has it
+
+static std::mt19937 rng(3);
+static uint32_t pick(uint32_t n) {return rng() % n;}
+
+typedef struct Scene {
+    std::vector<CMDBox*> boxes;
+    std::vector<CMDGrid*> grids;
+} Scene;
+
+static void decorate(CMDBox *box)
+{
+    if (pick(3) == 0) box->setBordered(true);
+    if (pick(3) == 0) box->setBorder("#*+|"[pick(4)]);
+    if (pick(4) == 0) box->isTransparent = true;
+    if (pick(3) == 0) box->setStyle(makeStyle(pick(17), pick(17), pick(128)));
+    box->textPosition = (TextPosition)pick(9);
+    if (pick(2)) box->setText(std::string(pick(12), "abcdef "[pick(7)]));
+}
+
+static void build(CMDFrame *frame, int depth, Scene &scene)
+{
+    uint32_t count = pick(5);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t kind = pick(4);
+        if (kind == 0 && depth < 3)
+        {
+            auto child = frame->addChild(std::make_unique<CMDFrame>("f", 1 + pick(30), 1 + pick(15)), pick(4));
+            decorate(child);
+            child->setPosition((TextPosition)pick(9));
+            scene.boxes.push_back(child);
+            build(child, depth + 1, scene);
+        }
+        else if (kind == 1 && depth < 3)
+        {
+            auto grid = frame->addChild(std::make_unique<CMDGrid>("g", 1 + pick(3), 1 + pick(3), 1 + pick(5), 1 + pick(3)), pick(3));
+            if (pick(2)) grid->setBordered(true);
+            grid->setPosition((TextPosition)pick(9));
+            grid->at(0, 0)->setText("cell");
+            scene.grids.push_back(grid);
+            scene.boxes.push_back(grid);
+        }
+        else
+        {
+            auto box = frame->addChild(std::make_unique<CMDBox>("b", 1 + pick(20), 1 + pick(8)), pick(4));
+            decorate(box);
+            box->setPosition((TextPosition)pick(9));
+            scene.boxes.push_back(box);
+        }
+    }
+}
+
+static void mutate(Scene &scene)
+{
+    auto box = scene.boxes[pick(scene.boxes.size())];
+    switch (pick(11))
+    {
+        case 0: box->setPosition((TextPosition)pick(9)); break;
+        case 1: if (box->getX() > 0 && box->getY() > 0) box->shift((int)pick(3) - 1, (int)pick(3) - 1); break;
+        case 2: box->setBorder("xyz"[pick(3)]); break;
+        case 3: box->setBordered(pick(2)); break;
+        case 4: box->setText(std::string(pick(10), "QRS"[pick(3)])); break;
+        case 5: box->setZIndex(pick(4)); break;
+        case 6: box->setStyle(makeStyle(pick(17), pick(17))); break;
+        case 7:
+            box->isVisible = !box->isVisible;
+            box->damage();
+            break;
+
+        case 8:
+            if (!scene.grids.empty())
+            {
+                auto grid = scene.grids[pick(scene.grids.size())];
+                grid->setWidth(pick(grid->columns.count), 1 + pick(6));
+            }
+            break;
+
+        case 9:
+            if (!scene.grids.empty())
+            {
+                auto grid = scene.grids[pick(scene.grids.size())];
+                grid->setHeight(pick(grid->rows.count), 1 + pick(3));
+            }
+            break;
+
+        case 10: box->setSize(1 + pick(20), 1 + pick(8)); break;
+    }
+}
+
+// what the screen shows where the tree leaves a hole
+static Cell shownCell(CMDFrame &root, uint32_t x, uint32_t y)
+{
+    Cell cell = root.getCellIn(x, y);
+    return cellGlyph(cell) == 0 ? makeCell(' ') : cell;
+}
+
+static bool matchesTree(CMDFrame &root, const MemorySink &screen)
+{
+    for (uint32_t y = 0; y < root.height; ++y)
+        for (uint32_t x = 0; x < root.width; ++x)
+            if (screen.cellAt(x, y) != shownCell(root, x, y)) return false;
+    return true;
+}
+
+// a box grown inside a transparent frame is redisplayed in full, even when only a sibling changes afterwards
+static void resizeInFrame()
+{
+    CMDFrame root("root", 20, 10);
+    MemorySink screen(20, 10);
+    root.setSink(&screen);
+
+    auto frame = root.addChild(std::make_unique<CMDFrame>("f", 12, 8), 0);
+    frame->isTransparent = true;
+    auto bx = frame->addChild(std::make_unique<CMDBox>("bx", "grown", 6, 2), 0);
+    bx->setBordered(true);
+    bx->setBorder('#');
+    auto sibling = frame->addChild(std::make_unique<CMDBox>("sibling", "a", 3, 1), 1);
+    sibling->setPosition(8, 0);
+    root.display();
+
+    bx->setHeight(7);
+    sibling->setText("b");
+    root.flush();
+    CHECK(matchesTree(root, screen));
+    CHECK(screen.at(0, 6) == '#');
+
+    bx->setSize(3, 3);
+    root.flush();
+    CHECK(matchesTree(root, screen));
+    CHECK(screen.at(0, 6) == ' ');
+}
+
+// a grid changed in a batch is drawn as it was laid out until the batch is committed
+static void batchedGrid()
+{
+    CMDFrame root("root", 20, 10);
+    MemorySink screen(20, 10);
+    root.setSink(&screen);
+
+    auto grid = root.addChild(std::make_unique<CMDGrid>("g", 2, 2, 3, 1), 0);
+    grid->at(0, 0)->addChild(std::make_unique<CMDBox>("a", "aaa", 3, 1), 0);
+    grid->at(1, 1)->addChild(std::make_unique<CMDBox>("b", "bbb", 3, 1), 0);
+    root.display();
+    std::vector<Cell> before;
+    for (uint32_t x = 0; x < 20; ++x) before.push_back(screen.cellAt(x, 1));
+
+    grid->beginUpdate();
+    grid->deleteRow(0);
+    grid->deleteColumn(0);
+    grid->addRow();
+    grid->setWidth(0, 5);
+    root.flush();
+    root.display();
+    bool kept = screen.at(0, 0) == 'a';
+    for (uint32_t x = 0; x < 20; ++x) kept = kept && screen.cellAt(x, 1) == before[x];
+    CHECK(kept);
+
+    grid->commitUpdate();
+    root.flush();
+    CHECK(matchesTree(root, screen));
+    CHECK(screen.at(0, 0) == 'b');
+    CHECK(screen.at(0, 1) == ' ');
+}
+
+// a batch begun on a frame defers the layout and damage of a grid inside it, until the batch is committed
+static void batchedFrame()
+{
+    CMDFrame root("root", 30, 10);
+    MemorySink screen(30, 10);
+    root.setSink(&screen);
+
+    auto frame = root.addChild(std::make_unique<CMDFrame>("f", 20, 8), 0);
+    auto grid = frame->addChild(std::make_unique<CMDGrid>("g", 2, 2, 3, 1), 0);
+    grid->at(1, 0)->addChild(std::make_unique<CMDBox>("a", "aaa", 3, 1), 0)->setPosition(TOP_LEFT);
+    root.display();
+    CHECK(screen.at(3, 0) == 'a');
+
+    root.beginUpdate();
+    frame->beginUpdate();
+    grid->setWidth(0, 5);
+    grid->addRow();
+    frame->commitUpdate();
+    CHECK(grid->width == 6);
+    CHECK(grid->height == 2);
+
+    // the inner batch leaves the layout to the outer one, and nothing is damaged until then
+    grid->setHeight(0, 3);
+    root.flush();
+    CHECK(screen.at(3, 0) == 'a');
+    CHECK(grid->width == 6);
+
+    root.commitUpdate();
+    CHECK(grid->width == 8);
+    CHECK(grid->height == 4);
+    root.flush();
+    CHECK(matchesTree(root, screen));
+    CHECK(screen.at(5, 0) == 'a');
+    CHECK(screen.at(3, 0) == ' ');
+
+    // a grid taken out of a batch is laid out on its way
+    frame->beginUpdate();
+    grid->setWidth(1, 1);
+    auto back = frame->removeChild(grid);
+    CHECK(grid->width == 6);
+    frame->commitUpdate();
+    root.flush();
+    CHECK(matchesTree(root, screen));
+}
+
+int main()
+{
+    for (int round = 0; round < 200; ++round)
+    {
+        uint32_t wid = 20 + pick(50), hig = 5 + pick(20);
+        CMDFrame root("root", wid, hig);
+        MemorySink screen(wid, hig);
+        root.setSink(&screen);
+
+        Scene scene;
+        build(&root, 0, scene);
+        root.display();
+        CHECK(matchesTree(root, screen));
+        if (scene.boxes.empty()) continue;
+
+        for (int step = 0; step < 30; ++step)
+        {
+            for (uint32_t changes = 1 + pick(3); changes > 0; --changes) mutate(scene);
+            root.flush();
+            CHECK(matchesTree(root, screen));
+        }
+
+        // and a full display writes the same screen again
+        MemorySink full(wid, hig);
+        root.setSink(&full);
+        root.display();
+        bool same = true;
+        for (uint32_t y = 0; y < hig; ++y)
+            for (uint32_t x = 0; x < wid; ++x) same = same && full.cellAt(x, y) == screen.cellAt(x, y);
+        CHECK(same);
+    }
+
+    resizeInFrame();
+    batchedGrid();
+    batchedFrame();
+    return checkResult();
+}
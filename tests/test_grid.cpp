@@ -0,0 +1,201 @@
+#include <random>
+#include <vector>
+#include "../include/frame.hpp"
+#include "check.hpp"
+
+// the offsets and lookup tables of a grid, and where its cells are placed, match ones computed cell by cell
+
+static std::mt19937 rng(5);
+static uint32_t pick(uint32_t n) {return rng() % n;}
+
+// a grid whose layout tables can be read
+class ProbedGrid : public CMDGrid
+{
+    public:
+        using CMDGrid::CMDGrid;
+        using CMDGrid::colStart;
+        using CMDGrid::rowStart;
+        using CMDGrid::colAt;
+        using CMDGrid::rowAt;
+};
+
+// the column or row under each offset, -1 on borders, walking the sizes one by one
+static std::vector<int32_t> lookup(const std::vector<uint32_t> &sizes, uint32_t count, bool bordered)
+{
+    std::vector<int32_t> at;
+    if (count == 0) return at;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (bordered) at.push_back(-1);
+        for (uint32_t n = 0; n < sizes[i]; ++n) at.push_back(i);
+    }
+    if (bordered) at.push_back(-1);
+    return at;
+}
+
+static bool matchesLayout(ProbedGrid &grid)
+{
+    bool bordered = grid.getBordered(false);
+    std::vector<int32_t> cols = lookup(grid.columns.colwidth, grid.columns.count, bordered);
+    std::vector<int32_t> rows = lookup(grid.rows.rowheight, grid.rows.count, bordered);
+    if (grid.width != cols.size() || grid.height != rows.size()) return false;
+    if (std::vector<int32_t>(grid.colAt.begin(), grid.colAt.begin() + grid.width) != cols) return false;
+    if (std::vector<int32_t>(grid.rowAt.begin(), grid.rowAt.begin() + grid.height) != rows) return false;
+
+    // each cell starts right after the border or cell before it
+    int32_t border = bordered ? 1 : 0;
+    int32_t y = border;
+    for (uint32_t row = 0; row < grid.rows.count; ++row)
+    {
+        int32_t x = border;
+        for (uint32_t col = 0; col < grid.columns.count; ++col)
+        {
+            auto cell = grid.at(col, row);
+            if ((uint32_t)x != grid.colStart[col] || (uint32_t)y != grid.rowStart[row]) return false;
+            if (cell->offx != x || cell->offy != y) return false;
+            if (cell->width != grid.columns.colwidth[col] || cell->height != grid.rows.rowheight[row]) return false;
+            if (cell->getX() != grid.getX() + x || cell->getY() != grid.getY() + y) return false;
+            x += grid.columns.colwidth[col] + border;
+        }
+        y += grid.rows.rowheight[row] + border;
+    }
+    return true;
+}
+
+static void resizedCells()
+{
+    for (int round = 0; round < 200; ++round)
+    {
+        CMDFrame root("root", 80, 40);
+        auto grid = root.addChild(std::make_unique<ProbedGrid>("g", 1 + pick(5), 1 + pick(5), pick(4), pick(3)), 0);
+        grid->setPosition(pick(10), pick(5));
+        if (pick(2)) grid->setBordered(true);
+        CHECK(matchesLayout(*grid));
+
+        for (int step = 0; step < 20; ++step)
+        {
+            switch (pick(3))
+            {
+                case 0: grid->setWidth(pick(grid->columns.count), pick(6)); break;
+                case 1: grid->setHeight(pick(grid->rows.count), pick(4)); break;
+                case 2: grid->setBordered(!grid->getBordered(false)); break;
+            }
+            CHECK(matchesLayout(*grid));
+        }
+    }
+}
+
+// rows and columns added and deleted, in batches or not, keep the other cells in order with what they hold
+static void insertedAndDeleted()
+{
+    for (int round = 0; round < 200; ++round)
+    {
+        CMDFrame root("root", 120, 60);
+        auto grid = root.addChild(std::make_unique<ProbedGrid>("g", pick(4), pick(4), 1 + pick(3), 1 + pick(2)), 0);
+        if (pick(2)) grid->setBordered(true);
+
+        // the cells expected in each row, and the name of the box each holds
+        std::vector<std::vector<CMDFrame*>> cells(grid->rows.count);
+        std::vector<std::vector<std::string>> names(grid->rows.count);
+        int named = 0;
+        auto fill = [&](uint32_t row, uint32_t col) {
+            std::string name = "box" + std::to_string(named++);
+            grid->addChild(std::make_unique<CMDBox>(name, 1, 1), 0, row, col);
+            names[row][col] = name;
+        };
+        for (uint32_t y = 0; y < grid->rows.count; ++y)
+            for (uint32_t x = 0; x < grid->columns.count; ++x)
+            {
+                cells[y].push_back(grid->at(x, y));
+                names[y].push_back("");
+                fill(y, x);
+            }
+
+        std::vector<std::string> deleted;
+        bool batched = pick(3) == 0;
+        if (batched) grid->beginUpdate();
+        for (int step = 0; step < 30; ++step)
+        {
+            uint32_t count = 0;
+            switch (pick(5))
+            {
+                case 0:
+                    grid->addRow();
+                    cells.emplace_back();
+                    names.emplace_back();
+                    for (uint32_t x = 0; x < grid->columns.count; ++x)
+                    {
+                        cells.back().push_back(grid->at(x, grid->rows.count - 1));
+                        names.back().push_back("");
+                        fill(grid->rows.count - 1, x);
+                    }
+                    break;
+
+                case 1:
+                    // enough columns to outgrow the room left in each row
+                    for (count = 1 + pick(6); count > 0; --count)
+                    {
+                        grid->addColumn();
+                        for (uint32_t y = 0; y < grid->rows.count; ++y)
+                        {
+                            cells[y].push_back(grid->at(grid->columns.count - 1, y));
+                            names[y].push_back("");
+                            fill(y, grid->columns.count - 1);
+                        }
+                    }
+                    break;
+
+                case 2:
+                    if (grid->rows.count == 0) break;
+                    count = pick(grid->rows.count);
+                    grid->deleteRow(count);
+                    deleted.insert(deleted.end(), names[count].begin(), names[count].end());
+                    cells.erase(cells.begin() + count);
+                    names.erase(names.begin() + count);
+                    break;
+
+                case 3:
+                    if (grid->columns.count == 0) break;
+                    count = pick(grid->columns.count);
+                    grid->deleteColumn(count);
+                    for (uint32_t y = 0; y < grid->rows.count; ++y)
+                    {
+                        deleted.push_back(names[y][count]);
+                        cells[y].erase(cells[y].begin() + count);
+                        names[y].erase(names[y].begin() + count);
+                    }
+                    break;
+
+                case 4:
+                    if (grid->columns.count > 0) grid->setWidth(pick(grid->columns.count), pick(4));
+                    if (grid->rows.count > 0) grid->setHeight(pick(grid->rows.count), pick(3));
+                    break;
+            }
+
+            // the cells are where they were, and hold what they held
+            bool kept = grid->rows.count == cells.size();
+            for (uint32_t y = 0; kept && y < grid->rows.count; ++y)
+            {
+                kept = grid->columns.count == cells[y].size();
+                for (uint32_t x = 0; kept && x < grid->columns.count; ++x)
+                {
+                    auto box = grid->getElementByName(names[y][x]);
+                    kept = grid->at(x, y) == cells[y][x] && box != NULL && box->parent == cells[y][x];
+                }
+            }
+            for (auto &name : deleted) kept = kept && grid->getElementByName(name) == NULL;
+            CHECK(kept);
+            if (!batched) CHECK(matchesLayout(*grid));
+        }
+
+        if (batched) grid->commitUpdate();
+        CHECK(matchesLayout(*grid));
+    }
+}
+
+int main()
+{
+    resizedCells();
+    insertedAndDeleted();
+    return checkResult();
+}
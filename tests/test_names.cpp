@@ -0,0 +1,47 @@
+#include "../include/frame.hpp"
+#include "check.hpp"
+
+// lookups through the name index find what a depth-first search of the tree finds
+
+int main()
+{
+    CMDFrame root("root", 40, 20);
+    auto back = root.addChild(std::make_unique<CMDFrame>("back", 20, 10), 0);
+    auto front = root.addChild(std::make_unique<CMDFrame>("front", 20, 10), 2);
+
+    // levels are searched highest first, so the box in front is met first
+    auto shallow = back->addChild(std::make_unique<CMDBox>("twin", 2, 2), 0);
+    auto deep = front->addChild(std::make_unique<CMDBox>("twin", 2, 2), 0);
+    CHECK(root.getElementByName("twin") == deep);
+    CHECK(back->getElementByName("twin") == shallow);
+
+    // within a frame, a child comes before the contents of the next one
+    auto inner = front->addChild(std::make_unique<CMDFrame>("inner", 5, 5), 1);
+    auto nested = inner->addChild(std::make_unique<CMDBox>("twin", 1, 1), 0);
+    CHECK(root.getElementByName("twin") == nested);
+    CHECK(front->getElementByName("twin") == nested);
+
+    // grids are searched row by row
+    auto grid = back->addChild(std::make_unique<CMDGrid>("grid", 2, 2, 3, 1), 5);
+    auto second = grid->addChild(std::make_unique<CMDBox>("cellbox", 1, 1), 0, 1, 0);
+    auto first = grid->addChild(std::make_unique<CMDBox>("cellbox", 1, 1), 0, 0, 1);
+    CHECK(root.getElementByName("cellbox") == first);
+    CHECK(grid->getElementByName("cellbox") == first);
+
+    // renames go through the index
+    first->setName("renamed");
+    CHECK(root.getElementByName("cellbox") == second);
+    CHECK(root.getElementByName("renamed") == first);
+    CHECK(first->getName() == "renamed");
+    nested->setName("solo");
+    CHECK(root.getElementByName("solo") == nested);
+    CHECK(root.getElementByName("twin") == deep);
+
+    // removed boxes are no longer found
+    auto removed = front->removeChild(inner);
+    CHECK(removed.get() == inner);
+    CHECK(root.getElementByName("solo") == NULL);
+    CHECK(inner->getElementByName("solo") == nested);
+
+    return checkResult();
+}
@@ -0,0 +1,196 @@
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include "../include/frame.hpp"
+#include "check.hpp"
+
+// frames delete the children handed to them as owners, and only those, however the children were allocated
+
+static int destroyed = 0;
+
+class Counted : public CMDBox
+{
+    public:
+        Counted(std::string nom) : CMDBox(nom, 2, 1) {}
+        ~Counted() {++destroyed;}
+};
+
+// a box built around another, which is allocated while the arguments are evaluated
+class Wrapper : public CMDBox
+{
+    public:
+        Wrapper(CMDBox *inner) : CMDBox("wrapper", 2, 1), inner(inner) {}
+        ~Wrapper() {delete inner;}
+        CMDBox *inner;
+};
+
+static std::string failingName()
+{
+    throw std::runtime_error("no name");
+}
+
+static void ownedChildren()
+{
+    destroyed = 0;
+    {
+        CMDFrame root("root", 20, 10);
+        auto frame = root.addChild(std::make_unique<CMDFrame>("frame", 10, 5), 0);
+        frame->addChild(std::make_unique<Counted>("a"), 0);
+        root.addChild(root.create<Counted>("b"), 1);
+        auto grid = root.addChild(std::make_unique<CMDGrid>("grid", 2, 2, 3, 1), 0);
+        grid->addChild(std::make_unique<Counted>("c"), 0, 1, 1);
+        CHECK(grid->addChild(std::make_unique<Counted>("d"), 0, 5, 5) == NULL);
+        CHECK(destroyed == 1);
+    }
+    CHECK(destroyed == 4);
+}
+
+static void borrowedChildren()
+{
+    destroyed = 0;
+
+    // a box held by a std::unique_ptr is only lent to the frame, and deleted once, by its owner
+    auto lent = std::make_unique<Counted>("lent");
+    Counted onStack("stack");
+    {
+        CMDFrame root("root", 20, 10);
+        root.addChild(lent.get(), 0);
+        root.addChild(&onStack, 1);
+        CHECK(!lent->isOwned());
+    }
+    CHECK(destroyed == 0);
+    CHECK(lent->parent == NULL);
+    lent.reset();
+    CHECK(destroyed == 1);
+
+    // a borrowed box destroyed first leaves the frame on its way
+    CMDFrame root("root", 20, 10);
+    MemorySink screen(20, 10);
+    root.setSink(&screen);
+    {
+        Counted inner("inner");
+        inner.setText("xy");
+        root.addChild(&inner, 0);
+        root.display();
+        CHECK(screen.at(0, 0) == 'x');
+    }
+    CHECK(root.getElementByName("inner") == NULL);
+    root.flush();
+    CHECK(screen.at(0, 0) == ' ');
+}
+
+static void removedChildren()
+{
+    destroyed = 0;
+    CMDFrame root("root", 20, 10);
+    auto owned = root.addChild(std::make_unique<Counted>("owned"), 0);
+    Counted lent("lent");
+    root.addChild(&lent, 0);
+
+    // ownership goes back with the child, and only if the frame had it
+    auto back = root.removeChild(owned);
+    CHECK(back.get() == owned);
+    CHECK(!owned->isOwned());
+    CHECK(root.removeChild(&lent) == NULL);
+    back.reset();
+    CHECK(destroyed == 1);
+
+    // deleting an owned child directly takes it out of the frame, so it is not deleted again
+    auto doomed = root.addChild(std::make_unique<Counted>("doomed"), 0);
+    delete doomed;
+    CHECK(destroyed == 2);
+    CHECK(root.getElementByName("doomed") == NULL);
+}
+
+static void movedChildren()
+{
+    destroyed = 0;
+    {
+        CMDFrame root("root", 20, 10);
+        auto a = root.addChild(std::make_unique<CMDFrame>("a", 10, 5), 0);
+        auto b = root.addChild(std::make_unique<CMDFrame>("b", 10, 5), 1);
+        auto box = a->addChild(std::make_unique<Counted>("box"), 0);
+
+        // a child added to another frame leaves the first one, and its owner goes with it
+        b->addChild(box, 0);
+        CHECK(!a->isParentTo(box));
+        CHECK(b->isParentTo(box));
+        CHECK(box->parent == b);
+        CHECK(box->isOwned());
+        CHECK(root.getElementByName("box") == box);
+
+        // and so does a child moved into a grid
+        auto grid = root.addChild(std::make_unique<CMDGrid>("grid", 1, 1, 4, 2), 2);
+        grid->addChild(box, 0, 0, 0);
+        CHECK(!b->isParentTo(box));
+        CHECK(grid->isParentTo(box));
+
+        // a lent child stays lent
+        Counted lent("lent");
+        a->addChild(&lent, 0);
+        b->addChild(&lent, 0);
+        CHECK(!a->isParentTo(&lent));
+        CHECK(!lent.isOwned());
+        b->removeChild(&lent);
+    }
+    CHECK(destroyed == 2);
+}
+
+static void failedConstruction()
+{
+    destroyed = 0;
+    CMDFrame root("root", 20, 10);
+
+    // a constructor that never ran hands its allocation to no other box
+    bool thrown = false;
+    try {new (root.getPool()) CMDBox(failingName());}
+    catch (const std::runtime_error &) {thrown = true;}
+    CHECK(thrown);
+
+    thrown = false;
+    try {new CMDBox(failingName());}
+    catch (const std::runtime_error &) {thrown = true;}
+    CHECK(thrown);
+
+    {
+        Counted onStack("stack");
+        CHECK(onStack.getPool() != root.getPool());
+        root.addChild(&onStack, 0);
+    }
+    CHECK(destroyed == 1);
+}
+
+static void nestedAllocation()
+{
+    CMDFrame root("root", 20, 10);
+    NodePool *pool = root.getPool();
+
+    // each box takes the pool of its own allocation, whichever is made first
+    auto outer = new (pool) Wrapper(new CMDBox("inner"));
+    CHECK(outer->getPool() == pool);
+    CHECK(outer->inner->getPool() != pool);
+    delete outer;
+
+    outer = new Wrapper(new (pool) CMDBox("inner"));
+    CHECK(outer->getPool() != pool);
+    CHECK(outer->inner->getPool() == pool);
+    delete outer;
+
+    // boxes constructed in place were allocated by nothing
+    alignas(CMDBox) unsigned char place[sizeof(CMDBox)];
+    auto box = new (place) CMDBox("placed");
+    CHECK((void*)box == place);
+    CHECK(box->getPool() != pool);
+    box->~CMDBox();
+}
+
+int main()
+{
+    ownedChildren();
+    borrowedChildren();
+    removedChildren();
+    movedChildren();
+    failedConstruction();
+    nestedAllocation();
+    return checkResult();
+}
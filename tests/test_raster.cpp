@@ -0,0 +1,114 @@
+#include <random>
+#include <string>
+#include <vector>
+#include "../include/frame.hpp"
+#include "../include/raster.hpp"
+#include "check.hpp"
+
+// every set of raster kernels the processor supports writes the same cells as the scalar one
+
+static std::mt19937 rng(13);
+static uint32_t pick(uint32_t n) {return rng() % n;}
+
+static const char *const KERNELS[] = {"scalar", "sse2", "avx2"};
+
+// a row of random cells, some of them holes
+static std::vector<Cell> randomRow(size_t len)
+{
+    std::vector<Cell> row(len);
+    for (auto &cell : row) cell = pick(4) ? makeCell(1 + pick(0x10ffff), pick(1 << 16)) : 0;
+    return row;
+}
+
+static void rows()
+{
+    for (int round = 0; round < 2000; ++round)
+    {
+        size_t len = pick(70), offset = pick(3);
+        std::vector<Cell> below = randomRow(len + offset);
+        Cell fill = makeCell(1 + pick(0x7f), pick(1 << 16));
+        Style style = pick(1 << 16);
+
+        std::string text(len + offset, 0);
+        std::vector<uint32_t> glyphs(len + offset, 0);
+        for (size_t i = 0; i < len + offset; ++i)
+        {
+            if (pick(4) == 0) continue;
+            text[i] = 1 + pick(0x7f);
+            glyphs[i] = 1 + pick(0x10ffff);
+        }
+
+        // what each operation writes, done one cell at a time
+        std::vector<Cell> filled = below, blitted = below, texted = below, glyphed = below;
+        std::vector<Cell> source = randomRow(len);
+        for (size_t i = 0; i < len; ++i)
+        {
+            filled[offset + i] = fill;
+            blitted[offset + i] = source[i];
+            if (text[offset + i] != 0) texted[offset + i] = makeCell((unsigned char)text[offset + i], style);
+            if (glyphs[offset + i] != 0) glyphed[offset + i] = makeCell(glyphs[offset + i], style);
+        }
+
+        for (auto name : KERNELS)
+        {
+            if (!useRasterKernels(name)) continue;
+            std::vector<Cell> row = below;
+            fillRow(row.data() + offset, fill, len);
+            CHECK(row == filled);
+
+            row = below;
+            blitRow(row.data() + offset, source.data(), len);
+            CHECK(row == blitted);
+
+            row = below;
+            compositeText(row.data() + offset, text.data() + offset, len, style);
+            CHECK(row == texted);
+
+            row = below;
+            compositeText(row.data() + offset, glyphs.data() + offset, len, style);
+            CHECK(row == glyphed);
+        }
+    }
+}
+
+// transparent boxes of text over a pattern paint the same cells with every set of kernels
+static void scenes()
+{
+    for (int round = 0; round < 200; ++round)
+    {
+        unsigned seed = rng();
+        std::vector<Cell> first;
+        for (auto name : KERNELS)
+        {
+            if (!useRasterKernels(name)) continue;
+            std::mt19937 local(seed);
+            CMDFrame root("root", 60, 20);
+            root.setText(std::string(1200, '.'));
+            root.setStyle(makeStyle(COLOR_BLUE, COLOR_BLACK));
+            for (int i = 0; i < 8; ++i)
+            {
+                std::string words = local() % 2 ? "a transparent box of text " : "\xe4\xb8\xad\xe6\x96\x87 wide \xe4\xb8\xad ";
+                std::string text;
+                for (uint32_t n = local() % 6; n > 0; --n) text += words;
+                auto box = root.addChild(std::make_unique<CMDBox>("b", text, 1 + local() % 50, 1 + local() % 8), local() % 3);
+                box->isTransparent = local() % 3 != 0;
+                box->setBordered(local() % 2);
+                box->textPosition = (TextPosition)(local() % 9);
+                box->setStyle(makeStyle(local() % 17, local() % 17));
+                box->setPosition(local() % 40, local() % 15);
+            }
+
+            FrameBuffer fb{60, 20, std::vector<Cell>(60 * 20, 0)};
+            root.paint(fb, {0, 0, 60, 20});
+            if (first.empty()) first = fb.cells;
+            else CHECK(fb.cells == first);
+        }
+    }
+}
+
+int main()
+{
+    rows();
+    scenes();
+    return checkResult();
+}
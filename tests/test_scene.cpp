@@ -0,0 +1,90 @@
+#include <random>
+#include <vector>
+#include "../include/frame.hpp"
+#include "check.hpp"
+
+// painting a random scene into any clip writes what getCellIn returns inside the clip, and nothing else
+
+static std::mt19937 rng(11);
+static int pick(int n) {return rng() % n;}
+
+// a cell no scene paints, marking what painting left untouched
+static const Cell UNTOUCHED = makeCell('~', makeStyle(COLOR_RED, COLOR_BLUE));
+
+static void build(CMDFrame &root)
+{
+    std::vector<CMDFrame*> frames{&root};
+    for (int i = 0; i < 12; ++i)
+    {
+        CMDFrame *parent = frames[pick(frames.size())];
+        switch (pick(4))
+        {
+            case 0:
+            {
+                auto frame = parent->addChild(std::make_unique<CMDFrame>("f", pick(20), pick(10)), pick(5) - 1);
+                frame->setBordered(pick(2));
+                frame->setBorder("#*+"[pick(3)]);
+                frame->isTransparent = pick(2);
+                frame->setPosition((TextPosition)pick(9));
+                frames.push_back(frame);
+                break;
+            }
+
+            case 1:
+            {
+                auto grid = parent->addChild(std::make_unique<CMDGrid>("g", pick(4), pick(4), pick(5), pick(3)), pick(4));
+                grid->setBordered(pick(2));
+                grid->setBorder('|');
+                grid->setPosition((TextPosition)pick(9));
+                if (grid->rows.count && grid->columns.count)
+                {
+                    auto box = grid->addChild(std::make_unique<CMDBox>("b", "txt"), 0, pick(grid->rows.count), pick(grid->columns.count));
+                    box->setPosition((TextPosition)pick(9));
+                }
+                break;
+            }
+
+            default:
+            {
+                auto box = parent->addChild(std::make_unique<CMDBox>("b", pick(4) ? std::string(pick(8), 'a' + pick(26)) : "\xe4\xb8\xad\xe6\x96\x87 x", pick(12), pick(5)), pick(4));
+                box->setBordered(pick(2));
+                box->setBorder('@');
+                box->textPosition = (TextPosition)pick(9);
+                box->isTransparent = pick(2);
+                box->isVisible = pick(5) != 0;
+                if (pick(3) == 0) box->setStyle(makeStyle(pick(17), pick(17), pick(128)));
+                box->setPosition((TextPosition)pick(9));
+                break;
+            }
+        }
+    }
+}
+
+int main()
+{
+    const uint32_t wid = 60, hig = 30;
+    for (int round = 0; round < 3000; ++round)
+    {
+        CMDFrame root("root", wid, hig);
+        build(root);
+
+        Rect clip = {pick(10), pick(5), (int)wid - pick(10), (int)hig - pick(5)};
+        FrameBuffer fb{wid, hig, std::vector<Cell>((size_t)wid * hig, UNTOUCHED)};
+        root.paint(fb, clip);
+
+        bool painted = true, looked = true;
+        for (uint32_t y = 0; y < hig; ++y)
+            for (uint32_t x = 0; x < wid; ++x)
+            {
+                Cell cell = root.getCellIn(x, y);
+                bool inside = (int)x >= clip.left && (int)x < clip.right && (int)y >= clip.top && (int)y < clip.bottom;
+                Cell expected = (inside && cell != 0) ? cell : UNTOUCHED;
+                painted = painted && fb.cells[(size_t)y * wid + x] == expected;
+                looked = looked && root.getCharIn(x, y) == cellGlyph(cell);
+            }
+        CHECK(painted);
+        CHECK(looked);
+    }
+
+    return checkResult();
+}
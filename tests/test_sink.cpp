@@ -0,0 +1,137 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include "../include/frame.hpp"
+#include "check.hpp"
+#include "vt.hpp"
+
+// the bytes an FdSink writes, replayed on a virtual terminal, leave the screen cell for cell as a full display has it
+
+static std::mt19937 rng(17);
+static uint32_t pick(uint32_t n) {return rng() % n;}
+
+static const char *const WORDS[] = {"hello", "aaaaaaaa", "    ", "\xe4\xb8\xad\xe6\x96\x87", "x\xef\xbc\xa1y", "--------", ""};
+
+static Style randomStyle()
+{
+    if (pick(2)) return 0;
+    return makeStyle(pick(3) ? pick(17) : paletteColor(pick(256)), pick(17), pick(128));
+}
+
+// everything written to a file since it was opened
+static std::string contents(FILE *file)
+{
+    std::fflush(file);
+    std::rewind(file);
+    std::string bytes;
+    char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), file)) > 0) bytes.append(buf, n);
+    return bytes;
+}
+
+// the screen of a terminal against one written by a full display, with the same halves of wide characters blanked
+static bool matchesDisplay(CMDFrame &root, const VirtualTerminal &term)
+{
+    MemorySink screen(root.width, root.height);
+    root.setSink(&screen);
+    root.display();
+    for (uint32_t y = 0; y < root.height; ++y)
+        for (uint32_t x = 0; x < root.width; ++x)
+            if (term.at(x, y) != screen.cellAt(x, y)) return false;
+    return true;
+}
+
+static void replayScenes()
+{
+    for (int round = 0; round < 300; ++round)
+    {
+        uint32_t wid = 20 + pick(40), hig = 5 + pick(15);
+        FILE *file = std::tmpfile();
+        FdSink sink(fileno(file));
+        sink.setCapabilities(pick(4));
+        if (pick(2)) sink.setColumns(wid);
+
+        CMDFrame root("root", wid, hig);
+        root.setSink(&sink);
+        std::vector<CMDBox*> boxes;
+        for (int i = 0; i < 15; ++i)
+        {
+            auto made = std::make_unique<CMDBox>("b", WORDS[pick(7)], 1 + pick(12), 1 + pick(5));
+            if (made->width > wid || made->height > hig) continue;
+            auto box = root.addChild(std::move(made), pick(3));
+            box->setPosition(pick(wid + 1 - box->width), pick(hig + 1 - box->height));
+            if (pick(2)) box->setStyle(randomStyle());
+            if (pick(2)) box->setBorderStyle(randomStyle());
+            boxes.push_back(box);
+        }
+        root.display();
+
+        for (int step = 0; step < 8 && !boxes.empty(); ++step)
+        {
+            for (uint32_t changes = 1 + pick(4); changes > 0; --changes)
+            {
+                auto box = boxes[pick(boxes.size())];
+                switch (pick(3))
+                {
+                    case 0: box->setStyle(randomStyle()); break;
+                    case 1: box->setBorder("*#+. "[pick(5)]); break;
+                    case 2: box->setText(WORDS[pick(7)]); break;
+                }
+            }
+            if (pick(2)) root.flush();
+            else root.display();
+        }
+
+        VirtualTerminal term(wid, hig);
+        term.feed(contents(file));
+        std::fclose(file);
+        CHECK(term.scrolls == 0);
+        CHECK(term.unknown == 0);
+        CHECK(matchesDisplay(root, term));
+    }
+}
+
+// the bytes written for one row of cells
+static std::string writeRow(uint32_t caps, uint32_t columns, const std::vector<Cell> &cells)
+{
+    FILE *file = std::tmpfile();
+    FdSink sink(fileno(file));
+    sink.setCapabilities(caps);
+    sink.setColumns(columns);
+    sink.writeRun(0, 0, cells.data(), cells.size());
+    sink.flush();
+    std::string bytes = contents(file);
+    std::fclose(file);
+    return bytes;
+}
+
+static void stretches()
+{
+    std::vector<Cell> row(40, makeCell('a'));
+    CHECK(writeRow(0, 0, row) == "\x1b[H" + std::string(40, 'a'));
+    CHECK(writeRow(CAP_REPEAT, 0, row) == "\x1b[Ha\x1b[39b");
+
+    // blanks are erased, and the cursor moved past them if more follows
+    row.assign(40, makeCell(' '));
+    row[39] = makeCell('z');
+    CHECK(writeRow(CAP_ERASE, 0, row) == "\x1b[H\x1b[39X\x1b[39Cz");
+
+    // blanks reaching the edge of the console are erased to the end of the line
+    row.pop_back();
+    CHECK(writeRow(CAP_ERASE, 39, row) == "\x1b[H\x1b[K");
+    CHECK(writeRow(CAP_ERASE, 0, row) == "\x1b[H\x1b[39X");
+    CHECK(writeRow(0, 39, row) == "\x1b[H" + std::string(39, ' '));
+
+    // short stretches are cheaper written out
+    row.assign(3, makeCell('a'));
+    CHECK(writeRow(CAP_REPEAT, 0, row) == "\x1b[Haaa");
+}
+
+int main()
+{
+    replayScenes();
+    stretches();
+    return checkResult();
+}
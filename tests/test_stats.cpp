@@ -0,0 +1,185 @@
+#include <set>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <unistd.h>
+#include "../include/frame.hpp"
+#include "../include/threadpool.hpp"
+#include "check.hpp"
+
+// frames collecting statistics count what they paint and write, and their traces are valid JSON
+
+// a JSON value read from `text`, keeping the names of the events in the trace
+typedef struct JsonReader {
+    std::string text;
+    size_t at = 0;
+    std::set<std::string> names;
+
+    void space() {while (at < text.size() && std::isspace((unsigned char)text[at])) ++at;}
+    bool eat(char c) {space(); if (at < text.size() && text[at] == c) {++at; return true;} return false;}
+
+    bool string(std::string &out)
+    {
+        if (!eat('"')) return false;
+        out.clear();
+        while (at < text.size() && text[at] != '"')
+        {
+            if (text[at] == '\\') ++at;
+            if (at < text.size()) out += text[at++];
+        }
+        return eat('"');
+    }
+
+    bool number()
+    {
+        space();
+        char *end = NULL;
+        std::strtod(text.c_str() + at, &end);
+        if (end == text.c_str() + at) return false;
+        at = end - text.c_str();
+        return true;
+    }
+
+    bool value()
+    {
+        space();
+        if (at >= text.size()) return false;
+        std::string str;
+        if (text[at] == '"') return string(str);
+        if (text[at] == '{')
+        {
+            ++at;
+            if (eat('}')) return true;
+            do
+            {
+                std::string key;
+                if (!string(key) || !eat(':')) return false;
+                if (key == "name")
+                {
+                    if (!string(str)) return false;
+                    names.insert(str);
+                }
+                else if (!value()) return false;
+            } while (eat(','));
+            return eat('}');
+        }
+        if (text[at] == '[')
+        {
+            ++at;
+            if (eat(']')) return true;
+            do {if (!value()) return false;} while (eat(','));
+            return eat(']');
+        }
+        for (auto word : {"true", "false", "null"})
+            if (text.compare(at, strlen(word), word) == 0) {at += strlen(word); return true;}
+        return number();
+    }
+
+    bool document() {return value() && (space(), at == text.size());}
+} JsonReader;
+
+static std::string contents(FILE *file)
+{
+    std::fflush(file);
+    std::rewind(file);
+    std::string bytes;
+    char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), file)) > 0) bytes.append(buf, n);
+    return bytes;
+}
+
+static void counters()
+{
+    FILE *file = std::tmpfile();
+    FdSink sink(fileno(file));
+    CMDFrame root("root", 40, 12);
+    root.setSink(&sink);
+    auto box = root.addChild(std::make_unique<CMDBox>("b", "counted", 10, 3), 0);
+    root.addChild(std::make_unique<CMDGrid>("g", 2, 2, 4, 1), 1)->setPosition(20, 5);
+    CHECK(root.getFrameStats().frame == 0);
+
+    // a frame not collecting counters counts nothing
+    root.display();
+    CHECK(root.getFrameStats().frame == 0);
+    CHECK(root.getFrameStats().spansPainted == 0);
+
+    root.setStatsEnabled(true);
+    root.invalidateScreen();
+    long before = std::ftell(file);
+    root.display();
+    FrameStats stats = root.getFrameStats();
+    CHECK(stats.frame == 1);
+    CHECK(stats.cellsChanged == 40 * 12);
+    CHECK(stats.boxesVisited >= 3);
+    CHECK(stats.spansPainted >= 12 + 3);
+    CHECK(stats.bytesWritten == (uint64_t)(std::ftell(file) - before));
+
+    // nothing damaged, nothing painted
+    root.flush();
+    stats = root.getFrameStats();
+    CHECK(stats.frame == 2);
+    CHECK(stats.cellsChanged == 0);
+    CHECK(stats.spansPainted == 0);
+    CHECK(stats.bytesWritten == 0);
+
+    box->setText("changed");
+    root.flush();
+    stats = root.getFrameStats();
+    CHECK(stats.frame == 3);
+    CHECK(stats.cellsChanged > 0);
+    CHECK(stats.spansPainted > 0);
+
+    root.setStatsEnabled(false);
+    std::fclose(file);
+}
+
+static void trace(ThreadPool &pool)
+{
+    char path[] = "/tmp/cmdframe-traceXXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    ::close(fd);
+
+    FILE *file = std::tmpfile();
+    FdSink sink(fileno(file));
+    {
+        CMDFrame root("root", 80, 40);
+        root.setSink(&sink);
+        root.setRenderPool(&pool);
+        root.addChild(std::make_unique<CMDBox>("b", "traced \"text\"", 30, 20), 0);
+        auto grid = root.addChild(std::make_unique<CMDGrid>("g", 3, 3, 5, 2), 1);
+
+        CHECK(root.startTrace(path));
+        root.display();
+        CHECK(root.getFrameStats().spansPainted > 0);
+        grid->setWidth(1, 8);
+        root.flush();
+        CHECK(root.getFrameStats().frame == 2);
+        root.stopTrace();
+    }
+    std::fclose(file);
+
+    FILE *written = std::fopen(path, "r");
+    CHECK(written != NULL);
+    if (written == NULL) return;
+    JsonReader json;
+    json.text = contents(written);
+    std::fclose(written);
+    std::remove(path);
+
+    CHECK(json.document());
+    for (auto name : {"frame", "raster", "band", "diff", "write", "layout", "frame counters"})
+        CHECK(json.names.count(name) == 1);
+    CHECK(json.text.find("\"spansPainted\"") != std::string::npos);
+}
+
+int main()
+{
+    ThreadPool pool(4);
+    counters();
+    trace(pool);
+    return checkResult();
+}
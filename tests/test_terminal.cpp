@@ -0,0 +1,178 @@
+#include <string>
+#include <thread>
+#include <csignal>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/wait.h>
+#include "../include/frame.hpp"
+#include "../include/terminal.hpp"
+#include "check.hpp"
+
+// a sink driving a pseudo-terminal takes it over on open, and gives it back as it was on close or on a fatal signal
+
+static const std::string ENTER = "\x1b[?1049h\x1b[?25l";
+static const std::string PROBE = "\x1b[H \x1b[b\x1b[6n";
+static const std::string LEAVE = "\x1b[?25h\x1b[?1049l";
+
+typedef struct Pty {
+    int master;
+    int slave;
+    struct termios before;
+
+    Pty()
+    {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        grantpt(master);
+        unlockpt(master);
+        slave = ::open(ptsname(master), O_RDWR | O_NOCTTY);
+        fcntl(master, F_SETFL, O_NONBLOCK);
+        struct winsize size = {24, 80, 0, 0};
+        ioctl(slave, TIOCSWINSZ, &size);
+        tcgetattr(slave, &before);
+    }
+    ~Pty()
+    {
+        ::close(slave);
+        ::close(master);
+    }
+
+    // everything written to the terminal since the last call, waiting a moment for it to end with `until`
+    std::string read(const std::string &until = "")
+    {
+        std::string bytes;
+        char buf[4096];
+        for (int tries = 0; tries < 2000; ++tries)
+        {
+            ssize_t n = ::read(master, buf, sizeof(buf));
+            if (n > 0) {bytes.append(buf, n); continue;}
+            if (until.empty() || bytes.find(until) != std::string::npos) break;
+            usleep(1000);
+        }
+        return bytes;
+    }
+
+    // whether the slave has the modes it had when the pty was made
+    bool restored()
+    {
+        struct termios now;
+        return tcgetattr(slave, &now) == 0 && now.c_lflag == before.c_lflag;
+    }
+} Pty;
+
+static bool endsWith(const std::string &bytes, const std::string &end)
+{
+    return bytes.size() >= end.size() && bytes.compare(bytes.size() - end.size(), end.size(), end) == 0;
+}
+
+static void openAndClose()
+{
+    Pty pty;
+    TerminalSink term(pty.slave);
+    uint32_t wid = 0, hig = 0;
+    CHECK(term.getSize(wid, hig) && wid == 80 && hig == 24);
+
+    // the probe for REP is answered with the cursor past both blanks
+    std::string probe;
+    std::thread answer([&] {
+        probe = pty.read(PROBE);
+        ssize_t written = ::write(pty.master, "\x1b[1;3R", 6);
+        (void)written;
+    });
+    CHECK(term.open());
+    answer.join();
+    CHECK(probe == ENTER + PROBE);
+    CHECK(term.getCapabilities() == (CAP_REPEAT | CAP_ERASE));
+    CHECK(pty.read() == "\x1b[2J");
+    CHECK(!pty.restored());
+
+    CMDFrame root("root", 6, 2);
+    root.setSink(&term);
+    root.addChild(std::make_unique<CMDBox>("b", "hi", 2, 1), 0);
+    root.display();
+    std::string frame = pty.read();
+    CHECK(frame.rfind("\x1b[?2026h", 0) == 0);
+    CHECK(endsWith(frame, "\x1b[?2026l"));
+
+    // a frame left half written is dropped on close
+    root.getElementByName("b")->setText("yo");
+    term.close();
+    CHECK(!term.isOpen());
+    CHECK(pty.read() == LEAVE);
+    CHECK(pty.restored());
+
+    // descriptors that are not terminals are not taken over
+    int fd = ::open("/dev/null", O_WRONLY);
+    TerminalSink none(fd);
+    CHECK(!none.open());
+    ::close(fd);
+}
+
+static void closeOnDestruction()
+{
+    Pty pty;
+    {
+        // left unanswered, the probe times out and REP is not used
+        TerminalSink term(pty.slave);
+        CHECK(term.open());
+        CHECK(term.getCapabilities() == CAP_ERASE);
+    }
+    CHECK(endsWith(pty.read(), LEAVE));
+    CHECK(pty.restored());
+}
+
+// a process ended by `sig` while it holds the terminal gives it back first
+static void restoredOnSignal(int sig)
+{
+    Pty pty;
+    pid_t child = fork();
+    if (child == 0)
+    {
+        TerminalSink term(pty.slave);
+        if (!term.open()) _exit(2);
+        for (;;) pause();
+    }
+
+    // the screen is cleared once the probe has timed out and the terminal is set up
+    pty.read("\x1b[2J");
+    CHECK(!pty.restored());
+    kill(child, sig);
+    int status = 0;
+    waitpid(child, &status, 0);
+    CHECK(WIFSIGNALED(status) && WTERMSIG(status) == sig);
+    CHECK(endsWith(pty.read(), LEAVE));
+    CHECK(pty.restored());
+}
+
+// signals the application handles itself are left to it
+static void handledSignal()
+{
+    Pty pty;
+    pid_t child = fork();
+    if (child == 0)
+    {
+        signal(SIGTERM, [](int) {_exit(3);});
+        TerminalSink term(pty.slave);
+        if (!term.open()) _exit(2);
+        for (;;) pause();
+    }
+
+    pty.read("\x1b[2J");
+    kill(child, SIGTERM);
+    int status = 0;
+    waitpid(child, &status, 0);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 3);
+    CHECK(!pty.restored());
+}
+
+int main()
+{
+    openAndClose();
+    closeOnDestruction();
+    restoredOnSignal(SIGTERM);
+    restoredOnSignal(SIGINT);
+    handledSignal();
+    return checkResult();
+}
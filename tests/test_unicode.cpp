@@ -0,0 +1,25 @@
+#include "../include/unicode.hpp"
+#include "check.hpp"
+
+// the generated width table, at the edges of what it distinguishes
+
+int main()
+{
+    CHECK(glyphWidth('a') == 1);
+    CHECK(glyphWidth(0x1b) == 0);
+    CHECK(glyphWidth(0x301) == 0);          // combining acute accent
+    CHECK(glyphWidth(0x4e2d) == 2);
+    CHECK(glyphWidth(0xff21) == 2);         // fullwidth A
+    CHECK(glyphWidth(0x1f600) == 2);
+
+    // unassigned code points are narrow, except in the ranges reserved for ideographs
+    CHECK(glyphWidth(0x378) == 1);
+    CHECK(glyphWidth(0xffff) == 1);
+    CHECK(glyphWidth(0x50000) == 1);
+    CHECK(glyphWidth(0x10ffff) == 1);
+    CHECK(glyphWidth(0x2fffd) == 2);
+    CHECK(glyphWidth(0x3fffd) == 2);
+
+    CHECK(textWidth("x\xe4\xb8\xad\xf4\x8f\xbf\xbf") == 4);
+    return checkResult();
+}
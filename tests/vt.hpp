@@ -0,0 +1,218 @@
+#ifndef VT_HPP
+#define VT_HPP
+#pragma once
+
+#include <cctype>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "../include/cell.hpp"
+#include "../include/unicode.hpp"
+
+// a screen replaying the output of a sink the way a VT-style terminal would, for the sequences sinks emit
+class VirtualTerminal
+{
+    public:
+
+        std::vector<Cell> cells;        // row-major, blanks in the default style to begin with
+        uint32_t width;
+        uint32_t height;
+        uint32_t cursorx = 0;
+        uint32_t cursory = 0;
+        size_t scrolls = 0;             // line feeds on the last row, which a real screen would scroll
+        size_t unknown = 0;             // sequences not understood, or characters taking no column
+
+        VirtualTerminal(uint32_t wid, uint32_t hig) : cells((size_t)wid * hig, makeCell(' ')), width(wid), height(hig) {}
+
+        Cell at(uint32_t x, uint32_t y) const {return cells[(size_t)y * width + x];}
+
+        /**
+         * @brief Interpret bytes written to the terminal
+         *
+         * @param bytes Output of a sink
+         */
+        void feed(const std::string &bytes)
+        {
+            for (size_t i = 0; i < bytes.size(); )
+            {
+                if (bytes[i] == '\x1b') i = control(bytes, i);
+                else if (bytes[i] == '\r')
+                {
+                    cursorx = 0;
+                    pending = false;
+                    ++i;
+                }
+                else if (bytes[i] == '\n')
+                {
+                    if (cursory + 1 == height) ++scrolls;
+                    else ++cursory;
+                    pending = false;
+                    ++i;
+                }
+                else put(decodeUtf8(bytes, i));
+            }
+        }
+
+    private:
+        Style style = 0;
+        bool pending = false;           // the last column was written, and the next character wraps
+        uint32_t last = ' ';            // character repeated by REP
+
+        Cell& cell(uint32_t x) {return cells[(size_t)cursory * width + x];}
+
+        // overwriting either half of a wide character blanks the other
+        void clobber(uint32_t x)
+        {
+            if (cellGlyph(cell(x)) == WIDE_CONTINUATION && x > 0) cell(x - 1) = makeCell(' ', cellStyle(cell(x - 1)));
+            else if (x + 1 < width && cellGlyph(cell(x + 1)) == WIDE_CONTINUATION) cell(x + 1) = makeCell(' ', cellStyle(cell(x + 1)));
+        }
+
+        void put(uint32_t glyph)
+        {
+            uint32_t columns = glyphWidth(glyph);
+            if (columns == 0 || (columns == 2 && width < 2))
+            {
+                ++unknown;
+                return;
+            }
+
+            if (pending || cursorx + columns > width)
+            {
+                cursorx = 0;
+                if (cursory + 1 == height) ++scrolls;
+                else ++cursory;
+            }
+            pending = false;
+
+            clobber(cursorx);
+            if (columns == 2) clobber(cursorx + 1);
+            cell(cursorx) = makeCell(glyph, style);
+            if (columns == 2) cell(cursorx + 1) = makeCell(WIDE_CONTINUATION, style);
+            last = glyph;
+
+            cursorx += columns;
+            if (cursorx >= width)
+            {
+                cursorx = width - 1;
+                pending = true;
+            }
+        }
+
+        void erase(uint32_t from, uint32_t to)
+        {
+            for (uint32_t x = from; x < to && x < width; ++x)
+            {
+                clobber(x);
+                cell(x) = makeCell(' ', makeStyle(COLOR_DEFAULT, styleBackground(style)));
+            }
+            pending = false;
+        }
+
+        size_t control(const std::string &bytes, size_t i)
+        {
+            // CSI, an optional private marker, parameters and a final byte; omitted parameters are -1
+            size_t j = i + 2;
+            bool priv = j < bytes.size() && bytes[j] == '?';
+            if (priv) ++j;
+            std::vector<int> params;
+            int value = -1;
+            for (; j < bytes.size() && (isdigit((unsigned char)bytes[j]) || bytes[j] == ';'); ++j)
+            {
+                if (bytes[j] == ';')
+                {
+                    params.push_back(value);
+                    value = -1;
+                }
+                else value = (value < 0 ? 0 : value * 10) + (bytes[j] - '0');
+            }
+            params.push_back(value);
+            if (j >= bytes.size() || bytes[i + 1] != '[')
+            {
+                ++unknown;
+                return bytes.size();
+            }
+
+            auto param = [&params](size_t k, int fallback) {return (k < params.size() && params[k] > 0) ? params[k] : fallback;};
+            uint32_t n = param(0, 1);
+            switch (priv ? 0 : bytes[j])
+            {
+                case 0:
+                    // private modes change nothing on the screen
+                    break;
+
+                case 'H':
+                    cursory = std::min<uint32_t>(param(0, 1), height) - 1;
+                    cursorx = std::min<uint32_t>(param(1, 1), width) - 1;
+                    pending = false;
+                    break;
+
+                case 'A': cursory -= std::min(n, cursory); pending = false; break;
+                case 'B': cursory = std::min(cursory + n, height - 1); pending = false; break;
+                case 'C': cursorx = std::min(cursorx + n, width - 1); pending = false; break;
+                case 'D': cursorx -= std::min(n, cursorx); pending = false; break;
+
+                case 'b':
+                    for (uint32_t k = 0; k < n; ++k) put(last);
+                    break;
+
+                case 'X': erase(cursorx, cursorx + n); break;
+                case 'K': erase(cursorx, width); break;
+
+                case 'J':
+                    std::fill(cells.begin(), cells.end(), makeCell(' '));
+                    break;
+
+                case 'n':
+                    // reports go to the other end
+                    break;
+
+                case 'm':
+                    select(params);
+                    break;
+
+                default:
+                    ++unknown;
+                    break;
+            }
+            return j + 1;
+        }
+
+        void select(const std::vector<int> &params)
+        {
+            uint32_t fg = styleForeground(style), bg = styleBackground(style), attrs = styleAttributes(style);
+            for (size_t k = 0; k < params.size(); ++k)
+            {
+                int p = params[k] < 0 ? 0 : params[k];
+                if (p == 0) fg = bg = attrs = 0;
+                else if (p == 1) attrs |= ATTR_BOLD;
+                else if (p == 2) attrs |= ATTR_DIM;
+                else if (p == 3) attrs |= ATTR_ITALIC;
+                else if (p == 4) attrs |= ATTR_UNDERLINE;
+                else if (p == 5) attrs |= ATTR_BLINK;
+                else if (p == 7) attrs |= ATTR_REVERSE;
+                else if (p == 9) attrs |= ATTR_STRIKE;
+                else if (p == 22) attrs &= ~(ATTR_BOLD | ATTR_DIM);
+                else if (p == 23) attrs &= ~ATTR_ITALIC;
+                else if (p == 24) attrs &= ~ATTR_UNDERLINE;
+                else if (p == 25) attrs &= ~ATTR_BLINK;
+                else if (p == 27) attrs &= ~ATTR_REVERSE;
+                else if (p == 29) attrs &= ~ATTR_STRIKE;
+                else if (p >= 30 && p <= 37) fg = COLOR_BLACK + p - 30;
+                else if (p == 39) fg = COLOR_DEFAULT;
+                else if (p >= 40 && p <= 47) bg = COLOR_BLACK + p - 40;
+                else if (p == 49) bg = COLOR_DEFAULT;
+                else if (p >= 90 && p <= 97) fg = COLOR_BRIGHT_BLACK + p - 90;
+                else if (p >= 100 && p <= 107) bg = COLOR_BRIGHT_BLACK + p - 100;
+                else if ((p == 38 || p == 48) && k + 2 < params.size() && params[k + 1] == 5)
+                {
+                    (p == 38 ? fg : bg) = paletteColor(params[k + 2]);
+                    k += 2;
+                }
+                else ++unknown;
+            }
+            style = makeStyle(fg, bg, attrs);
+        }
+};
+
+#endif
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""Generate src/widths.cpp, the columns taken by every code point.
+
+The table has two stages: the high bits of a code point pick a block of 256,
+and blocks are stored once each, four code points to a byte, 2 bits apiece.
+
+    python3 tools/widths.py > src/widths.cpp
+"""
+
+import unicodedata
+
+BLOCK = 256
+LIMIT = 0x110000
+
+# ranges taken as wide even where no character is assigned yet, as in EastAsianWidth.txt
+WIDE_DEFAULTS = [(0x3400, 0x4DBF), (0x4E00, 0x9FFF), (0xF900, 0xFAFF), (0x20000, 0x2FFFD), (0x30000, 0x3FFFD)]
+
+# conjoining jamo and other marks that join the character before them
+ZERO_RANGES = [(0x1160, 0x11FF), (0xD7B0, 0xD7FF), (0x200B, 0x200F), (0x2028, 0x202E), (0x2060, 0x2064)]
+
+
+def width(cp):
+    if cp < 0x20 or 0x7F <= cp < 0xA0:
+        return 0
+    if any(lo <= cp <= hi for lo, hi in ZERO_RANGES):
+        return 0
+    ch = chr(cp)
+    category = unicodedata.category(ch)
+    if category in ('Mn', 'Me') or (category == 'Cf' and cp != 0xAD):
+        return 0
+    wide_default = any(lo <= cp <= hi for lo, hi in WIDE_DEFAULTS)
+    # unassigned code points report some east_asian_width of their own, so only the wide ranges count for them
+    if category == 'Cn':
+        return 2 if wide_default else 1
+    if unicodedata.east_asian_width(ch) in ('W', 'F') or wide_default:
+        return 2
+    return 1
+
+
+def main():
+    blocks = []
+    index = {}
+    stage1 = []
+    for base in range(0, LIMIT, BLOCK):
+        packed = bytearray(BLOCK // 4)
+        for i in range(BLOCK):
+            packed[i // 4] |= width(base + i) << (i % 4 * 2)
+        packed = bytes(packed)
+        if packed not in index:
+            index[packed] = len(blocks)
+            blocks.append(packed)
+        stage1.append(index[packed])
+    assert len(blocks) <= 256
+
+    print('// generated by tools/widths.py from Unicode %s, do not edit' % unicodedata.unidata_version)
+    print('#include <cstdint>')
+    print()
+    print('extern const uint8_t WIDTH_BLOCKS[%d] = {' % len(stage1))
+    for i in range(0, len(stage1), 24):
+        print('    ' + ', '.join('%d' % b for b in stage1[i:i + 24]) + ',')
+    print('};')
+    print()
+    print('extern const uint8_t WIDTH_CELLS[%d][%d] = {' % (len(blocks), BLOCK // 4))
+    for packed in blocks:
+        print('    {' + ', '.join('0x%02x' % b for b in packed) + '},')
+    print('};')
+
+
+if __name__ == '__main__':
+    main()